@@ -0,0 +1,36 @@
+# Script run by oglu_embed_shaders() at build time
+#
+# Expects NAME, BASE_DIR, FILES (separated by "|") and OUTPUT.
+
+string(REPLACE "|" ";" FILES "${FILES}")
+
+set(line_pattern "")
+foreach(i RANGE 31)
+	string(APPEND line_pattern "[0-9a-f]")
+endforeach()
+
+set(arrays "")
+set(entries "")
+set(index 0)
+foreach(file ${FILES})
+	file(RELATIVE_PATH name ${BASE_DIR} ${file})
+	file(READ ${file} contents HEX)
+	string(LENGTH "${contents}" size)
+	math(EXPR size "${size} / 2")
+
+	# Two hex digits per byte, 16 bytes per line, terminated so the data can be used as a string too.
+	# Character literals instead of integers, bytes above 0x7f would be narrowing conversions otherwise
+	string(REGEX REPLACE "(${line_pattern})" "\\1\n\t\t" contents "${contents}")
+	string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," contents "${contents}")
+
+	string(APPEND arrays "\tconstexpr char ${NAME}_${index}[] = {\n\t\t${contents}'\\0'\n\t};\n\n")
+	string(APPEND entries "\t{ \"${name}\", ${NAME}_detail::${NAME}_${index}, ${size} },\n")
+	math(EXPR index "${index} + 1")
+endforeach()
+
+set(header "// Generated by oglu_embed_shaders(), do not edit\n")
+string(APPEND header "#pragma once\n\n#include <shader.hpp>\n\n")
+string(APPEND header "namespace ${NAME}_detail\n{\n${arrays}}\n\n")
+string(APPEND header "constexpr oglu::EmbeddedShaderFile ${NAME}[] = {\n${entries}};\n")
+
+file(WRITE ${OUTPUT} "${header}")
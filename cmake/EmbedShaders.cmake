@@ -0,0 +1,54 @@
+# Embeds shader files into a target at build time
+#
+#	oglu_embed_shaders(<target> NAME <table> FILES <files...> [BASE_DIR <dir>])
+#
+# Generates the header embedded/<table>.hpp, which defines the table
+# "constexpr oglu::EmbeddedShaderFile <table>[]" containing every file, and
+# adds it to the sources and include directories of <target>. The files are
+# stored under their path relative to BASE_DIR (defaults to the current source
+# directory), so e.g. "shaders/vertexShader.vert". Pass the table to
+# MakeShaderFromMemory() or ShaderFiles::embeddedFiles.
+#
+# The header is regenerated whenever one of the files changes.
+
+set(OGLU_EMBED_SHADER_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/EmbedShaderFiles.cmake)
+
+function(oglu_embed_shaders target)
+	cmake_parse_arguments(EMBED "" "NAME;BASE_DIR" "FILES" ${ARGN})
+
+	if(NOT EMBED_NAME)
+		message(FATAL_ERROR "oglu_embed_shaders: NAME is required")
+	endif()
+
+	if(NOT EMBED_BASE_DIR)
+		set(EMBED_BASE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+	endif()
+
+	set(dependencies "")
+	foreach(file ${EMBED_FILES})
+		get_filename_component(path ${file} ABSOLUTE BASE_DIR ${EMBED_BASE_DIR})
+		list(APPEND dependencies ${path})
+	endforeach()
+
+	# A list can't be passed through -D, the script splits it again
+	string(REPLACE ";" "|" files "${dependencies}")
+
+	set(output_dir ${CMAKE_CURRENT_BINARY_DIR}/embedded)
+	set(output ${output_dir}/${EMBED_NAME}.hpp)
+
+	add_custom_command(
+		OUTPUT ${output}
+		COMMAND ${CMAKE_COMMAND}
+			-DNAME=${EMBED_NAME}
+			-DBASE_DIR=${EMBED_BASE_DIR}
+			"-DFILES=${files}"
+			-DOUTPUT=${output}
+			-P ${OGLU_EMBED_SHADER_SCRIPT}
+		DEPENDS ${dependencies} ${OGLU_EMBED_SHADER_SCRIPT}
+		COMMENT "Embedding shaders into ${EMBED_NAME}"
+		VERBATIM
+	)
+
+	target_sources(${target} PRIVATE ${output})
+	target_include_directories(${target} PRIVATE ${output_dir})
+endfunction()
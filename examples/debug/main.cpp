@@ -9,6 +9,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/string_cast.hpp>
 
+// Generated from the shaders directory by oglu_embed_shaders()
+#include "debugShaders.hpp"
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	oglu::SetViewport(0, 0, width, height);
@@ -90,7 +93,7 @@ int main(int argc, char** argv)
 	oglu::Shader shader;
 	try
 	{
-		shader = oglu::MakeShader("shaders/vertexShader.vert", "shaders/fragmentShader.frag");
+		shader = oglu::MakeShaderFromMemory(debugShaders, sizeof(debugShaders), "shaders/vertexShader.vert", "shaders/fragmentShader.frag");
 	}
 	catch (const std::runtime_error& e)
 	{
@@ -0,0 +1,87 @@
+// Reports the vertex cache efficiency of a mesh before and after optimization
+//
+// Usage: meshoptimizer [model.obj]
+// Without a model a grid with its triangles in random order is used. Runs on
+// the CPU only, no window or context is created.
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <array>
+
+#include "openglu.hpp"
+
+// A flat grid of size x size quads whose triangles are shuffled
+static oglu::MeshData MakeShuffledGrid(int size)
+{
+	oglu::MeshData mesh;
+	for (int y = 0; y <= size; y++)
+	{
+		for (int x = 0; x <= size; x++)
+		{
+			GLfloat vertex[] = { (GLfloat)x, (GLfloat)y, 0.0f, 0.0f, 0.0f, 1.0f };
+			mesh.vertices.insert(mesh.vertices.end(), std::begin(vertex), std::end(vertex));
+		}
+	}
+
+	std::vector<std::array<GLuint, 3>> triangles;
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			GLuint corner = y * (size + 1) + x;
+			triangles.push_back({ corner, corner + 1, corner + size + 2 });
+			triangles.push_back({ corner, corner + size + 2, corner + size + 1 });
+		}
+	}
+
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1234));
+	for (const auto& triangle : triangles)
+		mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+
+	mesh.topology = {
+		{ 0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0 },
+		{ 2, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)) }
+	};
+
+	return mesh;
+}
+
+static void PrintStats(const char* name, const oglu::VertexCacheStats& stats)
+{
+	std::cout << std::setw(8) << name << "  ACMR " << std::setw(6) << stats.acmr << "  ATVR " << std::setw(6) << stats.atvr << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	oglu::MeshData mesh;
+	try
+	{
+		mesh = (argc > 1) ? oglu::LoadObj(argv[1]) : MakeShuffledGrid(256);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << mesh.GetVertexCount() << " vertices, " << mesh.indices.size() / 3 << " triangles" << std::endl;
+
+	for (unsigned int cacheSize : { 16u, 32u })
+	{
+		oglu::MeshData optimized = mesh;
+
+		auto start = std::chrono::steady_clock::now();
+		oglu::MeshOptimizationReport report = oglu::OptimizeMesh(optimized, true, cacheSize);
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "\nCache size " << cacheSize << ", optimized in " << milliseconds << " ms" << std::endl;
+		PrintStats("before", report.before);
+		PrintStats("after", report.after);
+	}
+
+	return 0;
+}
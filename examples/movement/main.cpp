@@ -9,6 +9,59 @@
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 
+// Generated from the shaders directory by oglu_embed_shaders()
+#include "movementShaders.hpp"
+
+// layout (std140) uniform Camera { mat4 view; mat4 projection; vec3 viewPos; };
+typedef oglu::UniformBlock<oglu::Std140, glm::mat4, glm::mat4, glm::vec3> CameraBlock;
+
+// struct Light { vec3 position; vec3 ambient, diffuse, specular; float ambientStrength; float constant, linear, quadratic; };
+typedef oglu::UniformBlock<oglu::Std140, glm::vec3, glm::vec3, glm::vec3, glm::vec3, float, float, float, float> PointLightBlock;
+
+// struct Flashlight { vec3 position, direction; float angle, outerAngle; vec3 diffuse, specular; float constant, linear, quadratic; };
+typedef oglu::UniformBlock<oglu::Std140, glm::vec3, glm::vec3, float, float, glm::vec3, glm::vec3, float, float, float> SpotLightBlock;
+
+// layout (std140) uniform Lighting { Light pointLight; Flashlight fl; };
+typedef oglu::UniformBlock<oglu::Std140, PointLightBlock, SpotLightBlock> LightingBlock;
+
+static_assert(CameraBlock::Size == 144, "Camera block doesn't match the std140 layout");
+static_assert(LightingBlock::Offset<1> == 80, "Lighting block doesn't match the std140 layout");
+
+enum { CameraBinding = 0, LightingBinding = 1 };
+
+using namespace oglu::literals;
+
+// Every uniform the cube pass writes, resolved once per program from its reflection
+struct CubePassSlots
+{
+	GLint model, normal;
+	GLint diffuse, specular, shininess;
+};
+
+GLint FindLocation(const oglu::ShaderReflection& reflection, const char* name)
+{
+	const oglu::ShaderUniformInfo* uniform = reflection.FindUniform(name);
+	return (uniform != nullptr) ? uniform->location : -1;
+}
+
+CubePassSlots ResolveCubePass(const oglu::Shader& shader)
+{
+	const oglu::ShaderReflection& reflection = shader->GetReflection();
+
+	// The uniform blocks on the C++ side have to match what the compiler laid out
+	const oglu::ShaderBlockInfo* lighting = reflection.FindUniformBlock("Lighting");
+	if (lighting != nullptr && lighting->dataSize != LightingBlock::Size)
+		std::cerr << "Lighting block is " << lighting->dataSize << " bytes, expected " << LightingBlock::Size << std::endl;
+
+	return CubePassSlots {
+		FindLocation(reflection, "model"),
+		FindLocation(reflection, "normal"),
+		FindLocation(reflection, "material.diffuse"),
+		FindLocation(reflection, "material.specular"),
+		FindLocation(reflection, "material.shininess")
+	};
+}
+
 bool firstMouse = true;
 bool escaped = false;
 double lastX = 0.0f;
@@ -166,8 +219,54 @@ int main(int argc, char** argv)
 		{ 2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)) }
 	};
 
-	// Make a square
-	oglu::VertexArray cubeDefault = oglu::MakeVertexArray(vertices, sizeof(vertices), nullptr, 0, topology, sizeof(topology));
+	// Submit the shaders first, the driver compiles them while the textures are loading
+	// The lit shader comes in two variants, the flashlight can be toggled at runtime
+	oglu::ShaderDefine flashlightDefines[] = {
+		{ "USE_FLASHLIGHT", "1" }
+	};
+
+	oglu::ShaderFiles shaderFiles[] = {
+		{ "shaders/vertexShader.vert", "shaders/fragmentShader.frag", flashlightDefines, sizeof(flashlightDefines) },
+		{ "shaders/vertexShader.vert", "shaders/fragmentShader.frag" },
+		{ "shaders/lightSourceShader.vert", "shaders/lightSourceShader.frag" }
+	};
+
+	// The sources are compiled into the executable, nothing is read from disk
+	for (oglu::ShaderFiles& files : shaderFiles)
+	{
+		files.embeddedFiles = movementShaders;
+		files.embeddedFilesSize = sizeof(movementShaders);
+	}
+
+	std::vector<oglu::PendingShader> pendingShaders;
+	try
+	{
+		oglu::SetShaderCacheDirectory("shadercache");
+		pendingShaders = oglu::MakeShaders(shaderFiles, sizeof(shaderFiles));
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	// Make a square, with half float positions and texture coordinates and octahedral normals
+	oglu::MeshData cubeMesh;
+	cubeMesh.vertices.assign(std::begin(vertices), std::end(vertices));
+	cubeMesh.topology.assign(std::begin(topology), std::end(topology));
+
+	oglu::AttributeEncoding cubeEncodings[] = {
+		{ 0, oglu::MakeHalfFloatEncoder() },
+		{ 1, oglu::MakeHalfFloatEncoder() },
+		{ 2, oglu::MakeOctahedralEncoder() }
+	};
+
+	oglu::MeshCompressionReport cubeReport = oglu::CompressMesh(cubeMesh, cubeEncodings, sizeof(cubeEncodings));
+	std::cout << "Cube vertices: " << cubeReport.strideBefore << " -> " << cubeReport.strideAfter << " bytes" << std::endl;
+	for (const oglu::AttributeCompressionStats& attribute : cubeReport.attributes)
+		std::cout << "  attribute " << attribute.index << ": " << attribute.sizeBefore << " -> " << attribute.sizeAfter << " bytes, max error " << attribute.maxError << std::endl;
+
+	oglu::VertexArray cubeDefault = oglu::MakeVertexArray(cubeMesh);
 	oglu::SharedMaterial cubeMaterial(new oglu::Material);
 
 	//cubeMaterial->AddProperty("ambient", oglu::Color::White);
@@ -223,12 +322,13 @@ int main(int argc, char** argv)
 	flashlight.linear = 0.09f;
 	flashlight.quadratic = 0.032f;
 
-	// Create a shader
-	oglu::Shader shader, lightSourceShader;
+	// Collect the shaders
+	oglu::Shader flashlightShader, noFlashlightShader, lightSourceShader;
 	try
 	{
-		shader = oglu::MakeShader("shaders/vertexShader.vert", "shaders/fragmentShader.frag");
-		lightSourceShader = oglu::MakeShader("shaders/lightSourceShader.vert", "shaders/lightSourceShader.frag");
+		flashlightShader = pendingShaders[0]->Get();
+		noFlashlightShader = pendingShaders[1]->Get();
+		lightSourceShader = pendingShaders[2]->Get();
 	}
 	catch (const std::runtime_error& e)
 	{
@@ -236,18 +336,64 @@ int main(int argc, char** argv)
 		return -1;
 	}
 
+	for (const oglu::Shader& s : { flashlightShader, noFlashlightShader, lightSourceShader })
+	{
+		const oglu::ShaderLoadInfo& info = s->GetLoadInfo();
+		std::cout << "Shader " << (info.fromCache ? "loaded from cache" : "compiled") << " in " << info.milliseconds << "ms, ready after " << info.latency << "ms" << std::endl;
+
+		s->SetUniformShadowing(true);
+		s->SetDirectStateAccess(true);
+	}
+
 	oglu::AmbientLight ambient;
 	ambient.intensity = 0.1f;
 
+	// Camera and lighting are uploaded once per frame and shared by both programs
+	CameraBlock cameraBlock;
+	LightingBlock lightingBlock;
+	PointLightBlock pointLightBlock;
+	SpotLightBlock spotLightBlock;
+
+	oglu::UniformBuffer cameraBuffer = oglu::MakeUniformBuffer<CameraBlock>();
+	oglu::UniformBuffer lightingBuffer = oglu::MakeUniformBuffer<LightingBlock>();
+	cameraBuffer->BindBase(CameraBinding);
+	lightingBuffer->BindBase(LightingBinding);
+
+	for (const oglu::Shader& s : { flashlightShader, noFlashlightShader })
+	{
+		s->BindUniformBlock("Camera", CameraBinding);
+		s->BindUniformBlock("Lighting", LightingBinding);
+	}
+	lightSourceShader->BindUniformBlock("Camera", CameraBinding);
+
+	CubePassSlots flashlightSlots = ResolveCubePass(flashlightShader);
+	CubePassSlots noFlashlightSlots = ResolveCubePass(noFlashlightShader);
+
+	// Draw every program once off-screen, so toggling the flashlight doesn't stall the first frame
+	oglu::ShaderWarmUp warmUps[] = {
+		{ flashlightShader, cubeDefault, true, false, false },
+		{ noFlashlightShader, cubeDefault, true, false, false },
+		{ lightSourceShader, cubeDefault, true, false, false }
+	};
+
+	std::vector<double> warmUpTimes = oglu::WarmUpShaders(warmUps, sizeof(warmUps));
+	for (size_t i = 0; i < warmUpTimes.size(); i++)
+		std::cout << "Warm-up draw " << i << " took " << warmUpTimes[i] << "ms" << std::endl;
+
 	camera.Move(0.0f, 0.0f, 5.0f);
 
 	// Window loop
 	oglu::Enable(GL_DEPTH_TEST);
+
+	// All cubes share a VAO, so it only needs to be bound once per frame
+	oglu::StateTracker& stateTracker = oglu::StateTracker::Current();
+	stateTracker.SetUnbindAfterDraw(false);
 	float t = 0.0f;
 
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
 	oglu::Color bgColor = oglu::Color::Black;
+	bool flashlightEnabled = true;
 	lightSource.SetPosition(1.0f, 1.0f, -1.0f);
 
 	while (!glfwWindowShouldClose(window))
@@ -262,48 +408,58 @@ int main(int argc, char** argv)
 		flashlight.SetPosition(camera.GetPosition());
 		flashlight.direction = camera.GetFront();
 
-		shader->Use();
-
-		shader->SetUniform("pointLight.ambient", "pointLight.ambientStrength", ambient);
-		shader->SetUniform3fv("pointLight.position", 1, glm::value_ptr(lightSource.GetPosition()));
-		shader->SetUniform("pointLight.diffuse", pointLight.diffusionColor, true);
-		shader->SetUniform("pointLight.specular", pointLight.specularColor, true);
-		shader->SetUniform("pointLight.constant", pointLight.constant);
-		shader->SetUniform("pointLight.linear", pointLight.linear);
-		shader->SetUniform("pointLight.quadratic", pointLight.quadratic);
-
-		shader->SetUniform3fv("fl.position", 1, glm::value_ptr(camera.GetPosition()));
-		shader->SetUniform3fv("fl.direction", 1, glm::value_ptr(flashlight.direction));
-		shader->SetUniform("fl.angle", glm::cos(glm::radians(flashlight.angle)));
-		shader->SetUniform("fl.outerAngle", glm::cos(glm::radians(flashlight.outerAngle)));
-		shader->SetUniform("fl.diffuse", flashlight.diffusionColor, true);
-		shader->SetUniform("fl.specular", flashlight.specularColor, true);
-		shader->SetUniform("fl.constant", flashlight.constant);
-		shader->SetUniform("fl.linear", flashlight.linear);
-		shader->SetUniform("fl.quadratic", flashlight.quadratic);
-
-		shader->SetUniform3fv("viewPos", 1, glm::value_ptr(camera.GetPosition()));
-
-		shader->SetUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(camera.GetMatrix()));
-		shader->SetUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(camera.GetProjection()));
-
-		shader->SetUniformTexture("material.diffuse", cubeMaterial->GetPropertyValue<oglu::Texture>("diffuse"), 0);
-		shader->SetUniformTexture("material.specular", cubeMaterial->GetPropertyValue<oglu::Texture>("specular"), 1);
-		shader->SetUniform("material.shininess", cubeMaterial->GetPropertyValue<float>("shininess"));
+		oglu::Shader shader = flashlightEnabled ? flashlightShader : noFlashlightShader;
+		const CubePassSlots& slots = flashlightEnabled ? flashlightSlots : noFlashlightSlots;
+		shader->ResetUniformUploadStats();
+		lightSourceShader->ResetUniformUploadStats();
+		stateTracker.ResetStats();
+
+		cameraBlock.Set<0>(camera.GetMatrix());
+		cameraBlock.Set<1>(camera.GetProjection());
+		cameraBlock.Set<2>(camera.GetPosition());
+		cameraBuffer->SetData(cameraBlock);
+
+		pointLightBlock.Set<0>(lightSource.GetPosition());
+		pointLightBlock.Set<1>(glm::vec3(ambient.color.r, ambient.color.g, ambient.color.b));
+		pointLightBlock.Set<2>(glm::vec3(pointLight.diffusionColor.r, pointLight.diffusionColor.g, pointLight.diffusionColor.b));
+		pointLightBlock.Set<3>(glm::vec3(pointLight.specularColor.r, pointLight.specularColor.g, pointLight.specularColor.b));
+		pointLightBlock.Set<4>(ambient.intensity);
+		pointLightBlock.Set<5>(pointLight.constant);
+		pointLightBlock.Set<6>(pointLight.linear);
+		pointLightBlock.Set<7>(pointLight.quadratic);
+
+		spotLightBlock.Set<0>(camera.GetPosition());
+		spotLightBlock.Set<1>(flashlight.direction);
+		spotLightBlock.Set<2>(glm::cos(glm::radians(flashlight.angle)));
+		spotLightBlock.Set<3>(glm::cos(glm::radians(flashlight.outerAngle)));
+		spotLightBlock.Set<4>(glm::vec3(flashlight.diffusionColor.r, flashlight.diffusionColor.g, flashlight.diffusionColor.b));
+		spotLightBlock.Set<5>(glm::vec3(flashlight.specularColor.r, flashlight.specularColor.g, flashlight.specularColor.b));
+		spotLightBlock.Set<6>(flashlight.constant);
+		spotLightBlock.Set<7>(flashlight.linear);
+		spotLightBlock.Set<8>(flashlight.quadratic);
+
+		lightingBlock.Set<0>(pointLightBlock);
+		lightingBlock.Set<1>(spotLightBlock);
+		lightingBuffer->SetData(lightingBlock);
+
+		// Uniforms are uploaded with direct state access, so each program is only bound right before its draws
+		lightSourceShader->SetUniformMatrix4fv("model"_uniform, 1, GL_FALSE, glm::value_ptr(lightSource.GetMatrix(true)));
+		lightSourceShader->SetUniform("color"_uniform, pointLight.diffusionColor, true);
+
+		shader->SetUniformTexture(slots.diffuse, cubeMaterial->GetPropertyValue<oglu::Texture>("diffuse"), 0);
+		shader->SetUniformTexture(slots.specular, cubeMaterial->GetPropertyValue<oglu::Texture>("specular"), 1);
+		shader->SetUniform(slots.shininess, cubeMaterial->GetPropertyValue<float>("shininess"));
 
 		for (oglu::Object& cube : cubes)
 		{
-			shader->SetUniform("model", cube);
-			shader->SetUniformMatrix3fv("normal", 1, GL_FALSE, glm::value_ptr(cube.GetNormalMatrix()));
+			shader->SetUniform(slots.model, cube);
+			shader->SetUniformMatrix3fv(slots.normal, 1, GL_FALSE, glm::value_ptr(cube.GetNormalMatrix()));
 
+			shader->Use();
 			cube.Render();
 		}
 
 		lightSourceShader->Use();
-		lightSourceShader->SetUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(lightSource.GetMatrix(true)));
-		lightSourceShader->SetUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(camera.GetMatrix()));
-		lightSourceShader->SetUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(camera.GetProjection()));
-		lightSourceShader->SetUniform("color", pointLight.diffusionColor, true);
 		lightSource.Render();
 
 		ImGui::Begin("Controls");
@@ -353,6 +509,7 @@ int main(int argc, char** argv)
 			ImGui::SetNextItemOpen(true, ImGuiCond_Once);
 			if (ImGui::TreeNode("Flashlight"))
 			{
+				ImGui::Checkbox("Enabled", &flashlightEnabled);
 				ImGui::ColorEdit3("Diffusion", &flashlight.diffusionColor.r);
 				ImGui::ColorEdit3("Specular", &flashlight.specularColor.r);
 				ImGui::SliderFloat("Angle", &flashlight.angle, 1.0f, flashlight.outerAngle - 1.0f);
@@ -378,6 +535,21 @@ int main(int argc, char** argv)
 			ImGui::SliderFloat("Shininess", cubeMaterial->GetProperty<float>("shininess"), 1.0f, 256.0f);
 		}
 
+		if (ImGui::CollapsingHeader("Statistics"))
+		{
+			const oglu::UniformCacheStats& cacheStats = shader->GetUniformCacheStats();
+			ImGui::Text("Uniform cache hits: %llu", cacheStats.hits);
+			ImGui::Text("Uniform cache misses: %llu", cacheStats.misses);
+
+			const oglu::UniformUploadStats& uploadStats = shader->GetUniformUploadStats();
+			ImGui::Text("Uniform uploads this frame: %llu", uploadStats.issued);
+			ImGui::Text("Redundant uploads skipped: %llu", uploadStats.skipped);
+
+			const oglu::StateTrackerStats& bindStats = stateTracker.GetStats();
+			ImGui::Text("Binds this frame: %llu", bindStats.issued);
+			ImGui::Text("Redundant binds elided: %llu", bindStats.elided);
+		}
+
 		ImGui::End();
 
 		ImGui::Render();
@@ -0,0 +1,70 @@
+#ifndef LIGHTING_GLSL
+#define LIGHTING_GLSL
+
+struct Material 
+{
+	sampler2D diffuse;
+	sampler2D specular;
+	float shininess;
+};
+
+struct Light
+{
+	vec3 position;
+	vec3 ambient, diffuse, specular;
+	float ambientStrength;
+
+	float constant, linear, quadratic;
+};
+
+struct Flashlight
+{
+	vec3 position, direction;
+	float angle, outerAngle;
+	vec3 diffuse, specular;
+
+	float constant, linear, quadratic;
+};
+
+vec3 CalcPointLight(Light light, Material material, vec2 uv, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+	vec3 lightDir = normalize(light.position - fragPos);
+
+	float diff = max(dot(normal, lightDir), 0.0);
+
+	vec3 reflectDir = reflect(-lightDir, normal);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+	float dist = length(light.position - fragPos);
+	float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * dist * dist);
+
+	vec3 ambient = light.ambient * light.ambientStrength * vec3(texture(material.diffuse, uv));
+	vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, uv));
+	vec3 specular = light.specular * spec * vec3(texture(material.specular, uv));
+
+	return (ambient + (diffuse + specular) * attenuation);
+}
+
+vec3 CalcSpotLight(Flashlight light, Material material, vec2 uv, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+	vec3 lightDir = normalize(light.position - fragPos);
+
+	float theta = dot(lightDir, -normalize(light.direction));
+	float epsilon = light.angle - light.outerAngle;
+	float intensity = clamp((theta - light.outerAngle) / epsilon, 0.0, 1.0);
+
+	float diff = max(dot(normal, lightDir), 0.0);
+
+	vec3 reflectDir = reflect(-lightDir, normal);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+
+	float dist = length(light.position - fragPos);
+	float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * dist * dist);
+
+	vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, uv));
+	vec3 specular = light.specular * spec * vec3(texture(material.specular, uv));
+
+	return ((diffuse + specular) * attenuation * intensity);
+}
+
+#endif
@@ -1,21 +1,34 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aUV;
-layout (location = 2) in vec3 aNormal;
+layout (location = 2) in vec2 aNormal;	// Octahedral
 
 out vec2 oUV;
 out vec3 oNormal;
 out vec3 oFragPos;
 
+layout (std140) uniform Camera
+{
+	mat4 view;
+	mat4 projection;
+	vec3 viewPos;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat3 normal;
 
+vec3 OctahedralDecode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
 void main()
 {
 	oUV = aUV;
-	oNormal = normal * aNormal;
+	oNormal = normal * OctahedralDecode(aNormal);
 	gl_Position = projection * view * model * vec4(aPos, 1.0);
 	oFragPos = vec3(model * vec4(aPos, 1.0));
 }
\ No newline at end of file
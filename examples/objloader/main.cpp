@@ -0,0 +1,122 @@
+// Measures the throughput of the OBJ loader
+//
+// Usage: objloader [model.obj] [runs]
+// Without a model a tessellated sphere with positions, texture coordinates,
+// normals and quad faces is generated first.
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+#include "openglu.hpp"
+
+// Writes a UV sphere with (segments + 1)^2 vertices of each kind and segments^2 quads
+static void WriteSphere(const char* filepath, int segments)
+{
+	std::ofstream file(filepath);
+	file.precision(6);
+	file << std::fixed;
+
+	const float pi = 3.14159265f;
+	for (int y = 0; y <= segments; y++)
+	{
+		for (int x = 0; x <= segments; x++)
+		{
+			float u = (float)x / segments, v = (float)y / segments;
+			float nx = std::cos(u * 2 * pi) * std::sin(v * pi);
+			float ny = std::cos(v * pi);
+			float nz = std::sin(u * 2 * pi) * std::sin(v * pi);
+
+			file << "v " << nx * 2.5f << " " << ny * 2.5f << " " << nz * 2.5f << "\n";
+			file << "vt " << u << " " << v << "\n";
+			file << "vn " << nx << " " << ny << " " << nz << "\n";
+		}
+	}
+
+	for (int y = 0; y < segments; y++)
+	{
+		for (int x = 0; x < segments; x++)
+		{
+			int corners[4] = {
+				y * (segments + 1) + x + 1,
+				y * (segments + 1) + x + 2,
+				(y + 1) * (segments + 1) + x + 2,
+				(y + 1) * (segments + 1) + x + 1
+			};
+
+			file << "f";
+			for (int corner : corners)
+				file << " " << corner << "/" << corner << "/" << corner;
+			file << "\n";
+		}
+	}
+}
+
+// Loads the model a few times and returns the fastest run in seconds
+static double Measure(const char* filepath, unsigned int threads, int runs, oglu::MeshData& mesh)
+{
+	double best = 1e30;
+	for (int i = 0; i < runs; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		mesh = oglu::LoadObj(filepath, threads);
+		best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	const char* filepath = (argc > 1) ? argv[1] : "benchmark.obj";
+	int runs = (argc > 2) ? std::max(1, atoi(argv[2])) : 5;
+
+	if (argc <= 1)
+	{
+		std::cout << "Generating " << filepath << "..." << std::endl;
+		WriteSphere(filepath, 800);
+	}
+
+	double megabytes;
+	try
+	{
+		oglu::MappedFile file(filepath);
+		megabytes = file.GetSize() / (1024.0 * 1024.0);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << filepath << ": " << megabytes << " MB, best of " << runs << " runs" << std::endl;
+
+	for (unsigned int threads : { 1u, hardwareThreads })
+	{
+		oglu::MeshData mesh;
+		double seconds;
+		try
+		{
+			seconds = Measure(filepath, threads, runs, mesh);
+		}
+		catch (const std::runtime_error& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return -1;
+		}
+
+		std::cout << threads << " thread(s): " << seconds * 1000.0 << " ms, "
+			<< megabytes / seconds << " MB/s, "
+			<< mesh.GetVertexCount() << " vertices, "
+			<< mesh.indices.size() / 3 << " triangles" << std::endl;
+
+		if (threads == hardwareThreads)
+			break;
+	}
+
+	return 0;
+}
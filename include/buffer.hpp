@@ -0,0 +1,212 @@
+/*****************************************************************//**
+ * \file   buffer.hpp
+ * \brief  Generic buffer objects and range management
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef BUFFER_HPP
+#define BUFFER_HPP
+
+#include <core.hpp>
+
+#include <map>
+
+namespace oglu
+{
+	class AbstractBuffer;
+
+	typedef std::shared_ptr<AbstractBuffer> Buffer;
+
+	/**
+	 * @brief An object representing an OpenGL buffer object.
+	 *
+	 * The buffer isn't tied to a target, so the same storage can hold vertices for
+	 * one VAO and be read as indices by another. Uploads go through GL_COPY_WRITE_BUFFER,
+	 * so they never change the element buffer of the currently bound VAO.
+	 *
+	 * This class cannot be instantiated, this should be done via MakeBuffer().
+	 */
+	class OGLU_API AbstractBuffer
+	{
+	public:
+		/**
+		 * @brief Constructs a new buffer.
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] data Initial contents of the buffer, nullptr to leave it uninitialized
+		 * @param[in] usage Usage hint of the buffer
+		 *
+		 * @return A shared pointer to the buffer.
+		 */
+		friend Buffer OGLU_API MakeBuffer(GLsizeiptr size, const void* data, GLenum usage);
+
+		/**
+		 * @brief Constructs a new buffer with immutable storage.
+		 *
+		 * The storage is allocated with glBufferStorage(), so it can't be resized, but
+		 * it can be mapped persistently. Also see: AbstractStreamBuffer
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] data Initial contents of the buffer, nullptr to leave it uninitialized
+		 * @param[in] flags Storage flags, e.g. GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+		 *
+		 * @throws std::runtime_error If the context doesn't support immutable buffer storage
+		 *
+		 * @return A shared pointer to the buffer.
+		 */
+		friend Buffer OGLU_API MakeBufferStorage(GLsizeiptr size, const void* data, GLbitfield flags);
+
+		/**
+		 * @brief Copy constructor.
+		 *
+		 * Copying a buffer is generally possible. Since the user is given a shared pointer the
+		 * buffer is only deleted once every instance has been deconstructed.
+		 *
+		 * @param[in] other Buffer to copy from
+		 */
+		AbstractBuffer(const AbstractBuffer& other);
+		~AbstractBuffer();
+
+		/**
+		 * @brief Bind this buffer to a target.
+		 *
+		 * @param[in] target The target, e.g. GL_ARRAY_BUFFER
+		 */
+		void Bind(GLenum target);
+
+		/**
+		 * @brief Unbind a target.
+		 *
+		 * @param[in] target The target, e.g. GL_ARRAY_BUFFER
+		 */
+		void Unbind(GLenum target);
+
+		/**
+		 * @brief Change the size of the buffer.
+		 *
+		 * The handle stays the same, so VAOs that reference the buffer stay valid.
+		 *
+		 * @param[in] size New size of the buffer in bytes
+		 * @param[in] preserve True to keep the contents that fit into the new size
+		 *
+		 * @throws std::runtime_error If the buffer has immutable storage
+		 */
+		void Resize(GLsizeiptr size, bool preserve = true);
+
+		/**
+		 * @brief Update a part of the buffer.
+		 *
+		 * @param[in] data Data to copy into the buffer
+		 * @param[in] offset Offset into the buffer
+		 * @param[in] size Size of @p data in bytes, the range must fit into the buffer
+		 */
+		void SetData(const void* data, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Get the size of the buffer.
+		 *
+		 * @return Size of the buffer in bytes.
+		 */
+		GLsizeiptr GetSize() const;
+
+		/**
+		 * @brief Get the handle of the buffer.
+		 */
+		GLuint GetHandle() const;
+
+	private:
+		/**
+		 * @brief Construct a buffer.
+		 *
+		 * To avoid accidental deletion of buffers while they're still in use,
+		 * this constructor has been made private. To create a buffer use
+		 * MakeBuffer().
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] data Initial contents of the buffer, may be nullptr
+		 * @param[in] usage Usage hint of the buffer
+		 */
+		AbstractBuffer(GLsizeiptr size, const void* data, GLenum usage);
+
+		/**
+		 * @brief Construct a buffer with immutable storage.
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] data Initial contents of the buffer, may be nullptr
+		 * @param[in] flags Storage flags
+		 * @param[in] immutable Always true, distinguishes this constructor from the one taking a usage hint
+		 */
+		AbstractBuffer(GLsizeiptr size, const void* data, GLbitfield flags, bool immutable);
+
+	private:
+		GLuint buffer;		///< Handle to the OpenGL buffer
+		GLsizeiptr size;	///< Size of the buffer in bytes
+		GLenum usage;		///< Usage hint the storage is (re)allocated with
+		bool immutable;		///< Wether the storage was allocated with glBufferStorage()
+	};
+
+	Buffer OGLU_API MakeBuffer(GLsizeiptr size, const void* data = nullptr, GLenum usage = GL_STATIC_DRAW);
+	Buffer OGLU_API MakeBufferStorage(GLsizeiptr size, const void* data = nullptr, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT);
+
+	/**
+	 * @brief Manages the free ranges of a linear storage.
+	 *
+	 * The allocator only does the bookkeeping, it doesn't care what the storage
+	 * is or which unit it is measured in (bytes, vertices, indices...). Free ranges
+	 * are kept sorted by offset and merged with their neighbours when a range is
+	 * returned, allocations take the first range that is large enough.
+	 */
+	class OGLU_API BufferAllocator
+	{
+	public:
+		/**
+		 * @brief Create an allocator.
+		 *
+		 * @param[in] capacity Size of the managed storage
+		 */
+		BufferAllocator(size_t capacity = 0);
+
+		/**
+		 * @brief Reserve a range.
+		 *
+		 * @param[in] size Size of the range
+		 * @param[out] offset Receives the offset of the range
+		 *
+		 * @return False if there is no free range of that size.
+		 */
+		bool Allocate(size_t size, size_t& offset);
+
+		/**
+		 * @brief Return a range that was reserved with Allocate().
+		 *
+		 * @param[in] offset Offset of the range
+		 * @param[in] size Size of the range
+		 */
+		void Free(size_t offset, size_t size);
+
+		/**
+		 * @brief Make the managed storage larger, the added part is free.
+		 *
+		 * @param[in] capacity New size of the storage, must not be smaller than the current one
+		 */
+		void Grow(size_t capacity);
+
+		/**
+		 * @brief Get the size of the managed storage.
+		 */
+		size_t GetCapacity() const;
+
+		/**
+		 * @brief Get the sum of the sizes of all reserved ranges.
+		 */
+		size_t GetUsed() const;
+
+	private:
+		std::map<size_t, size_t> freeRanges;	///< Sizes of the free ranges by their offset
+		size_t capacity;						///< Size of the managed storage
+		size_t used;							///< Sum of the sizes of all reserved ranges
+	};
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*****************************************************************//**
+ * \file   computeShader.hpp
+ * \brief  Compute shader programs and memory barriers
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef COMPUTESHADER_HPP
+#define COMPUTESHADER_HPP
+
+#include <core.hpp>
+#include <shader.hpp>
+
+#include <glm/glm.hpp>
+
+namespace oglu
+{
+	class AbstractComputeShader;
+
+	typedef std::shared_ptr<AbstractComputeShader> ComputeShader;
+
+	/**
+	 * @brief A shader program consisting of a single compute stage.
+	 *
+	 * Compute shaders are built, cached and shared exactly like other shader programs
+	 * and have the same uniform interface. Dispatching a compute shader makes it the
+	 * active program. Compute shaders require OpenGL 4.3.
+	 *
+	 * Writes of a dispatch are not visible to later commands until a matching
+	 * barrier was issued, see IssueMemoryBarrier().
+	 *
+	 * This class cannot be instantiated, this should be done via MakeComputeShader().
+	 */
+	class OGLU_API AbstractComputeShader : public AbstractShader
+	{
+	public:
+		/**
+		 * @brief Constructs a new compute shader program.
+		 *
+		 * The source is run through the same preprocessor as other stages, so it may use
+		 * `#include` and the @p defines are inserted after its `#version` directive.
+		 *
+		 * Compute shaders can also be built in a batch with MakeShaders() by passing a
+		 * single GL_COMPUTE_SHADER stage. The resulting Shader can then be cast with
+		 * std::static_pointer_cast<AbstractComputeShader>().
+		 *
+		 * @param[in] computeShaderFile Filepath to the compute shader
+		 * @param[in] defines Array of definitions to inject
+		 * @param[in] definesSize Size of the defines array
+		 *
+		 * @throws std::runtime_error If the context doesn't support compute shaders or the program failed to build
+		 *
+		 * @return A shared pointer to the compute shader program.
+		 */
+		friend ComputeShader OGLU_API MakeComputeShader(const char* computeShaderFile, const ShaderDefine* defines, size_t definesSize);
+
+		friend class AbstractPendingShader;
+
+		/**
+		 * @brief Launch work groups.
+		 *
+		 * @param[in] groupsX Amount of work groups in X direction
+		 * @param[in] groupsY Amount of work groups in Y direction
+		 * @param[in] groupsZ Amount of work groups in Z direction
+		 */
+		void Dispatch(GLuint groupsX, GLuint groupsY = 1, GLuint groupsZ = 1);
+
+		/**
+		 * @brief Launch enough work groups to cover a number of invocations.
+		 *
+		 * The amount of work groups is the amount of invocations divided by the
+		 * local size of the shader, rounded up. The shader has to discard the
+		 * invocations that are out of range itself.
+		 *
+		 * @param[in] invocationsX Amount of invocations in X direction
+		 * @param[in] invocationsY Amount of invocations in Y direction
+		 * @param[in] invocationsZ Amount of invocations in Z direction
+		 */
+		void DispatchInvocations(GLuint invocationsX, GLuint invocationsY = 1, GLuint invocationsZ = 1);
+
+		/**
+		 * @brief Launch work groups with counts read from a buffer.
+		 *
+		 * The buffer is bound to GL_DISPATCH_INDIRECT_BUFFER and has to contain three
+		 * GLuint work group counts at @p offset. If the counts were written by a shader,
+		 * issue a CommandBarrier() first.
+		 *
+		 * @param[in] buffer Handle to the buffer containing the work group counts
+		 * @param[in] offset Offset of the counts into the buffer, must be a multiple of 4
+		 */
+		void DispatchIndirect(GLuint buffer, GLintptr offset = 0);
+
+		/**
+		 * @brief Get the local size declared by the shader.
+		 *
+		 * @return The amount of invocations of a work group in each direction.
+		 */
+		const glm::uvec3& GetWorkGroupSize() const;
+
+	private:
+		/**
+		 * @brief Construct a compute shader program.
+		 *
+		 * To avoid accidental deletion of shader programs while they're still in use,
+		 * this constructor has been made private. To create a compute shader use
+		 * MakeComputeShader().
+		 *
+		 * @param[in] program Handle to a successfully linked compute program, the shader takes ownership of it
+		 * @param[in] loadInfo Information about how the program was created
+		 */
+		AbstractComputeShader(GLuint program, const ShaderLoadInfo& loadInfo);
+
+	private:
+		glm::uvec3 workGroupSize;	///< Local size of the shader
+	};
+
+	ComputeShader OGLU_API MakeComputeShader(const char* computeShaderFile, const ShaderDefine* defines = nullptr, size_t definesSize = 0);
+
+	/**
+	 * @brief Wrapper for glMemoryBarrier.
+	 *
+	 * Makes the incoherent writes of previous commands (e.g. shader storage and image
+	 * stores) visible to the kind of access described by @p barriers.
+	 *
+	 * @param[in] barriers Bitfield of GL_*_BARRIER_BIT values describing how the data is used next
+	 */
+	void OGLU_API IssueMemoryBarrier(GLbitfield barriers = GL_ALL_BARRIER_BITS);
+
+	/**
+	 * @brief Makes previous writes visible to shader storage block accesses.
+	 */
+	void OGLU_API StorageBarrier();
+
+	/**
+	 * @brief Makes previous writes visible to image loads and stores and texture fetches.
+	 */
+	void OGLU_API ImageBarrier();
+
+	/**
+	 * @brief Makes previous writes visible to vertex attribute and index fetches.
+	 *
+	 * Use this after a compute shader generated geometry that is drawn next.
+	 */
+	void OGLU_API VertexBarrier();
+
+	/**
+	 * @brief Makes previous writes visible to indirect draw and dispatch commands.
+	 */
+	void OGLU_API CommandBarrier();
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*****************************************************************//**
+ * \file   hash.hpp
+ * \brief  64 bit FNV-1a hashing used by the caches
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace oglu
+{
+	constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;	///< Starting value of every FNV-1a hash
+	constexpr uint64_t FNV_PRIME = 0x100000001b3ull;				///< Multiplier applied after every byte
+
+	/**
+	 * @brief 64 bit FNV-1a hash of arbitrary data.
+	 *
+	 * @param[in] data The data to hash
+	 * @param[in] length Size of @p data in bytes
+	 * @param[in] hash Result of a previous call to continue hashing from
+	 *
+	 * @return The hash.
+	 */
+	inline uint64_t HashBytes(const void* data, size_t length, uint64_t hash = FNV_OFFSET_BASIS)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+
+		return hash;
+	}
+}
+
+#endif
@@ -0,0 +1,61 @@
+/*****************************************************************//**
+ * \file   mappedFile.hpp
+ * \brief  Read-only memory mapped files
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <core.hpp>
+
+namespace oglu
+{
+	/**
+	 * @brief A file that is mapped into memory for reading.
+	 *
+	 * The contents are paged in by the operating system on access, nothing is
+	 * copied. The mapping is released when the object is destroyed.
+	 * Note that the contents are not null terminated.
+	 */
+	class OGLU_API MappedFile
+	{
+	public:
+		/**
+		 * @brief Maps a file.
+		 *
+		 * @param[in] filename Path to the file
+		 *
+		 * @throws std::runtime_error If the file can't be opened or mapped
+		 */
+		MappedFile(const char* filename);
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		~MappedFile();
+
+		/**
+		 * @brief Get the contents of the file.
+		 *
+		 * @return Pointer to the first byte, nullptr for empty files.
+		 */
+		const char* GetData() const;
+
+		/**
+		 * @brief Get the size of the file in bytes.
+		 */
+		size_t GetSize() const;
+
+	private:
+		const char* data;	///< Start of the mapping
+		size_t size;		///< Length of the mapping
+
+#ifdef OGLU_WIN32
+		void* file;			///< Handle to the file
+		void* mapping;		///< Handle to the file mapping
+#endif
+	};
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*****************************************************************//**
+ * \file   mesh.hpp
+ * \brief  CPU side mesh data and model loading
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <core.hpp>
+#include <vertexArray.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	/**
+	 * @brief A triangle mesh in system memory.
+	 *
+	 * The vertices are interleaved as described by the topology, so the mesh can be
+	 * passed to MakeVertexArray() or AbstractMeshPool::Add() as it is.
+	 */
+	struct OGLU_API MeshData
+	{
+		/*@{*/
+		std::vector<GLfloat> vertices;			///< Interleaved vertex data, attributes of other types than GL_FLOAT are stored bit for bit. Also see: CompressMesh()
+		std::vector<GLuint> indices;			///< Triangle list, three indices per triangle
+		std::vector<VertexAttribute> topology;	///< Layout of a vertex, every attribute uses the same stride
+		/*@}*/
+
+		/**
+		 * @brief Get the size of a vertex in bytes.
+		 */
+		GLsizei GetStride() const;
+
+		/**
+		 * @brief Get the amount of vertices.
+		 */
+		size_t GetVertexCount() const;
+	};
+
+	/**
+	 * @brief Loads a Wavefront .obj file.
+	 *
+	 * The file is memory mapped and split into chunks at line boundaries, which are parsed
+	 * on separate threads. `v`, `vt` and `vn` lines are read, faces may reference them
+	 * as `a`, `a/b`, `a//c` or `a/b/c`, with negative (relative) indices, and polygons
+	 * with more than three corners are triangulated as fans. Every distinct combination
+	 * of position, texture coordinate and normal becomes one vertex. Other statements,
+	 * like groups or materials, are ignored.
+	 *
+	 * The vertices contain a position (location 0), followed by a texture coordinate
+	 * (location 1) if any face references one and a normal (location 2) if any face
+	 * references one. Corners without them get zeros.
+	 *
+	 * @param[in] filepath Path to the .obj file
+	 * @param[in] threads Amount of threads to parse with, 0 to use one per hardware thread
+	 *
+	 * @throws std::runtime_error If the file can't be read or a face references a missing element
+	 *
+	 * @return The mesh.
+	 */
+	MeshData OGLU_API LoadObj(const char* filepath, unsigned int threads = 0);
+
+	/**
+	 * @brief Constructs a new VAO from a mesh.
+	 *
+	 * @param[in] mesh The mesh to upload
+	 *
+	 * @return A shared pointer to the VAO.
+	 */
+	VertexArray OGLU_API MakeVertexArray(const MeshData& mesh);
+}
+
+#endif
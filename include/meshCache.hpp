@@ -0,0 +1,112 @@
+/*****************************************************************//**
+ * \file   meshCache.hpp
+ * \brief  Binary mesh files that are uploaded without parsing
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef MESHCACHE_HPP
+#define MESHCACHE_HPP
+
+#include <core.hpp>
+#include <mesh.hpp>
+#include <vertexArray.hpp>
+
+#include <cstdint>
+
+namespace oglu
+{
+	/**
+	 * @brief Header at the start of every mesh cache file.
+	 *
+	 * The header is followed by attributeCount MeshCacheAttribute entries. The vertex
+	 * and index data are stored behind them, each starting at a multiple of 64 bytes,
+	 * exactly as they are uploaded. All values are in the byte order of the machine
+	 * that wrote the file.
+	 */
+	struct OGLU_API MeshCacheHeader
+	{
+		/*@{*/
+		char magic[4];				///< Always "OGLM"
+		uint32_t version;			///< Version of the format, files of other versions are ignored
+		uint64_t sourceSize;		///< Size of the source model in bytes
+		int64_t sourceTime;			///< Last write time of the source model
+		uint64_t sourceHash;		///< 64 bit FNV-1a hash of the source model
+		uint32_t stride;			///< Size of a vertex in bytes
+		uint32_t attributeCount;	///< Amount of MeshCacheAttribute entries following the header
+		uint32_t indexType;			///< GL_UNSIGNED_SHORT if every index fits into 16 bits, GL_UNSIGNED_INT otherwise, or 0 if the mesh has no indices
+		uint32_t reserved;			///< Always 0
+		uint64_t vertexCount;		///< Amount of vertices
+		uint64_t indexCount;		///< Amount of indices
+		float boundsMin[3];			///< Smallest position of the mesh
+		float boundsMax[3];			///< Largest position of the mesh
+		uint64_t vertexOffset;		///< Offset of the vertex data from the start of the file
+		uint64_t vertexSize;		///< Size of the vertex data in bytes
+		uint64_t indexOffset;		///< Offset of the index data from the start of the file
+		uint64_t indexSize;			///< Size of the index data in bytes
+		/*@}*/
+	};
+
+	/**
+	 * @brief A vertex attribute as it is stored in a mesh cache file.
+	 */
+	struct OGLU_API MeshCacheAttribute
+	{
+		/*@{*/
+		uint32_t index;			///< Index of the vertex attribute
+		int32_t size;			///< Number of elements in this attribute
+		uint32_t type;			///< Datatype of the elements
+		uint32_t normalized;	///< Normalize fixed-point data
+		uint64_t offset;		///< Offset of this attribute into a vertex
+		/*@}*/
+	};
+
+	/**
+	 * @brief Write a mesh to a cache file.
+	 *
+	 * @param[in] cacheFile Path of the file to write
+	 * @param[in] mesh The mesh to store
+	 * @param[in] sourceFile Model the mesh was loaded from, its size, timestamp and hash are recorded. May be nullptr
+	 *
+	 * @return False if the file couldn't be written.
+	 */
+	bool OGLU_API WriteMeshCache(const char* cacheFile, const MeshData& mesh, const char* sourceFile = nullptr);
+
+	/**
+	 * @brief Constructs a new VAO from a cache file.
+	 *
+	 * The file is memory mapped and its vertex and index data are passed to
+	 * glBufferData as they are. If @p sourceFile is given, the file is only used if it
+	 * was written from the current version of that model: its size and timestamp have to
+	 * match, or if only the timestamp differs, its hash. When the hash matches, the new
+	 * timestamp is written into the file, so the next call doesn't have to hash the model again.
+	 *
+	 * @param[in] cacheFile Path of the cache file
+	 * @param[in] sourceFile Model the cache file has to belong to, may be nullptr
+	 *
+	 * @return A shared pointer to the VAO, or nullptr if the file doesn't exist, is invalid or out of date.
+	 */
+	VertexArray OGLU_API MakeVertexArrayFromCache(const char* cacheFile, const char* sourceFile = nullptr);
+
+	/**
+	 * @brief Set the directory of the mesh cache.
+	 *
+	 * When a cache directory is set, MakeVertexArray(const char* filepath) stores every
+	 * model it loads in it. Later calls map that file instead of parsing the model again,
+	 * as long as the model didn't change. The directory is created if it doesn't exist.
+	 *
+	 * @param[in] directory Path to the cache directory, or nullptr to disable the cache
+	 */
+	void OGLU_API SetMeshCacheDirectory(const char* directory);
+
+	/**
+	 * @brief Get the path of the cache file of a model.
+	 *
+	 * @param[in] sourceFile Path to the model
+	 *
+	 * @return Path inside the cache directory, or an empty string if no cache directory is set.
+	 */
+	std::string OGLU_API GetMeshCacheFile(const char* sourceFile);
+}
+
+#endif
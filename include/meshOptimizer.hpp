@@ -0,0 +1,99 @@
+/*****************************************************************//**
+ * \file   meshOptimizer.hpp
+ * \brief  Reordering of triangles and vertices for faster rendering
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+
+#include <core.hpp>
+#include <mesh.hpp>
+
+namespace oglu
+{
+	/**
+	 * @brief Efficiency of a triangle order on a simulated post-transform vertex cache.
+	 *
+	 * The cache is simulated as a FIFO, which is what most hardware behaves like.
+	 */
+	struct OGLU_API VertexCacheStats
+	{
+		/*@{*/
+		float acmr;		///< Average cache miss ratio: transformed vertices per triangle, 3 is the worst, around 0.5 the best for regular grids
+		float atvr;		///< Average transformed vertex ratio: transformed vertices per vertex, 1 is the best
+		/*@}*/
+	};
+
+	/**
+	 * @brief Vertex cache efficiency before and after OptimizeMesh().
+	 */
+	struct OGLU_API MeshOptimizationReport
+	{
+		/*@{*/
+		VertexCacheStats before;	///< Stats of the mesh as it was passed in
+		VertexCacheStats after;		///< Stats of the optimized mesh
+		/*@}*/
+	};
+
+	/**
+	 * @brief Simulate the post-transform vertex cache for a mesh.
+	 *
+	 * @param[in] mesh The mesh
+	 * @param[in] cacheSize Amount of vertices the simulated cache holds
+	 *
+	 * @return The ACMR and ATVR of the triangle order.
+	 */
+	VertexCacheStats OGLU_API AnalyzeVertexCache(const MeshData& mesh, unsigned int cacheSize = 16);
+
+	/**
+	 * @brief Reorder the triangles so that vertices are reused while they're still cached.
+	 *
+	 * Uses Tipsify (Sander et al., "Fast Triangle Reordering for Vertex Locality and
+	 * Reduced Overdraw"), which runs in linear time. The vertices aren't touched.
+	 *
+	 * @param[in,out] mesh The mesh to reorder
+	 * @param[in] cacheSize Amount of vertices the targeted cache holds
+	 */
+	void OGLU_API OptimizeVertexCache(MeshData& mesh, unsigned int cacheSize = 16);
+
+	/**
+	 * @brief Reorder clusters of triangles so that occluders tend to be drawn first.
+	 *
+	 * The triangle list is split into clusters wherever the vertex cache is flushed anyway
+	 * or the ACMR of the cluster so far is good enough. The clusters are then sorted so that
+	 * the ones facing away from the center of the mesh come first. This only keeps the
+	 * vertex cache efficiency if it runs after OptimizeVertexCache().
+	 *
+	 * The positions are read from the attribute at index 0, which has to consist of at least
+	 * three floats, otherwise the mesh is left as it is.
+	 *
+	 * @param[in,out] mesh The mesh to reorder
+	 * @param[in] cacheSize Amount of vertices the targeted cache holds
+	 * @param[in] threshold How much worse than the ACMR of the whole mesh a cluster may be, 1.05 allows 5%
+	 */
+	void OGLU_API OptimizeOverdraw(MeshData& mesh, unsigned int cacheSize = 16, float threshold = 1.05f);
+
+	/**
+	 * @brief Reorder the vertices in the order they are first used by the triangles.
+	 *
+	 * This makes vertex fetches mostly sequential. Vertices that no triangle uses are removed.
+	 *
+	 * @param[in,out] mesh The mesh to reorder
+	 */
+	void OGLU_API OptimizeVertexFetch(MeshData& mesh);
+
+	/**
+	 * @brief Run all optimizations in the right order.
+	 *
+	 * @param[in,out] mesh The mesh to optimize
+	 * @param[in] reduceOverdraw Also run OptimizeOverdraw()
+	 * @param[in] cacheSize Amount of vertices the targeted cache holds
+	 *
+	 * @return The vertex cache efficiency before and after.
+	 */
+	MeshOptimizationReport OGLU_API OptimizeMesh(MeshData& mesh, bool reduceOverdraw = true, unsigned int cacheSize = 16);
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*****************************************************************//**
+ * \file   meshPool.hpp
+ * \brief  Packs many meshes into shared vertex and index buffers
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef MESHPOOL_HPP
+#define MESHPOOL_HPP
+
+#include <core.hpp>
+#include <buffer.hpp>
+#include <vertexArray.hpp>
+
+namespace oglu
+{
+	class AbstractMeshPool;
+
+	typedef std::shared_ptr<AbstractMeshPool> MeshPool;
+
+	/**
+	 * @brief Storage shared by many meshes with the same vertex layout.
+	 *
+	 * Every mesh added to the pool gets a range of one large vertex buffer and one large
+	 * index buffer instead of its own buffers, and all meshes are drawn through the same
+	 * VAO using glDrawElementsBaseVertex(). This saves a GL allocation per mesh, and
+	 * drawing meshes of the same pool in a row doesn't rebind the VAO if
+	 * StateTracker::SetUnbindAfterDraw() was disabled.
+	 *
+	 * The ranges are managed with a free list: a mesh gives its ranges back once its last
+	 * VertexArray is released, and the buffers grow (keeping their handles) if a new
+	 * mesh doesn't fit into the free ranges.
+	 *
+	 * This class cannot be instantiated, this should be done via MakeMeshPool().
+	 */
+	class OGLU_API AbstractMeshPool : public std::enable_shared_from_this<AbstractMeshPool>
+	{
+	public:
+		/**
+		 * @brief Constructs a new mesh pool.
+		 *
+		 * @param[in] topology Array of VertexAttribute shared by all meshes, the stride must not be 0
+		 * @param[in] topologySize Size of the topology array
+		 * @param[in] vertexCapacity Amount of vertices to reserve storage for
+		 * @param[in] indexCapacity Amount of indices to reserve storage for
+		 * @param[in] indexType Type the indices are stored as, GL_UNSIGNED_SHORT halves the index memory if no mesh has more than 65536 vertices
+		 *
+		 * @throws std::runtime_error If the topology has no stride or @p indexType isn't GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 *
+		 * @return A shared pointer to the mesh pool.
+		 */
+		friend MeshPool OGLU_API MakeMeshPool(const VertexAttribute* topology, size_t topologySize, size_t vertexCapacity, size_t indexCapacity, GLenum indexType);
+
+		AbstractMeshPool(const AbstractMeshPool& other) = delete;
+		~AbstractMeshPool();
+
+		/**
+		 * @brief Copy a mesh into the pool.
+		 *
+		 * The returned VAO keeps the pool alive. The indices are relative to the
+		 * first vertex of the mesh, just like for MakeVertexArray().
+		 *
+		 * @param[in] vertices		Array of vertex data, laid out as described by the topology of the pool
+		 * @param[in] verticesSize	Size of vertex array
+		 * @param[in] indices		Array of index data, or nullptr to draw the vertices in order
+		 * @param[in] indicesSize	Size of index array
+		 *
+		 * @return A VAO drawing the mesh.
+		 */
+		VertexArray Add(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize);
+
+		/**
+		 * @brief Copy a mesh with indices of any size into the pool.
+		 *
+		 * The indices are converted to the index type of the pool.
+		 *
+		 * @param[in] vertices		Array of vertex data, laid out as described by the topology of the pool
+		 * @param[in] verticesSize	Size of vertex array
+		 * @param[in] indices		Array of index data, or nullptr to draw the vertices in order
+		 * @param[in] indicesSize	Size of index array
+		 * @param[in] indexType		Type of the indices, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 *
+		 * @throws std::runtime_error If @p indexType is invalid or an index doesn't fit into the index type of the pool
+		 *
+		 * @return A VAO drawing the mesh.
+		 */
+		VertexArray Add(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType);
+
+		/**
+		 * @brief Get the buffer holding the vertices of all meshes.
+		 */
+		const Buffer& GetVertexBuffer() const;
+
+		/**
+		 * @brief Get the buffer holding the indices of all meshes.
+		 */
+		const Buffer& GetIndexBuffer() const;
+
+		/**
+		 * @brief Get the amount of vertices that are in use.
+		 */
+		size_t GetVertexCount() const;
+
+		/**
+		 * @brief Get the amount of indices that are in use.
+		 */
+		size_t GetIndexCount() const;
+
+		/**
+		 * @brief Get the type the indices are stored as.
+		 */
+		GLenum GetIndexType() const;
+
+	private:
+		/**
+		 * @brief Construct a mesh pool.
+		 *
+		 * To avoid accidental deletion of pools while they're still in use,
+		 * this constructor has been made private. To create a pool use
+		 * MakeMeshPool().
+		 *
+		 * @param[in] topology Array of VertexAttribute shared by all meshes
+		 * @param[in] topologySize Size of the topology array
+		 * @param[in] vertexCapacity Amount of vertices to reserve storage for
+		 * @param[in] indexCapacity Amount of indices to reserve storage for
+		 * @param[in] indexType Type the indices are stored as
+		 */
+		AbstractMeshPool(const VertexAttribute* topology, size_t topologySize, size_t vertexCapacity, size_t indexCapacity, GLenum indexType);
+
+		/**
+		 * @brief Reserve a range, growing the buffer if no free range is large enough.
+		 *
+		 * @param[in,out] allocator Free list of the buffer, in elements
+		 * @param[in] buffer The buffer
+		 * @param[in] elementSize Size of an element in bytes
+		 * @param[in] count Amount of elements to reserve
+		 *
+		 * @return The offset of the range in elements.
+		 */
+		static size_t Reserve(BufferAllocator& allocator, const Buffer& buffer, size_t elementSize, size_t count);
+
+	private:
+		GLuint VAO;						///< Handle to the VAO shared by all meshes
+		GLsizei stride;					///< Size of a vertex in bytes
+		GLenum indexType;				///< Type of the indices in indexBuffer
+		Buffer vertexBuffer;			///< Buffer holding the vertices of all meshes
+		Buffer indexBuffer;				///< Buffer holding the indices of all meshes
+		BufferAllocator vertices;		///< Free ranges of vertexBuffer, in vertices
+		BufferAllocator indices;		///< Free ranges of indexBuffer, in indices
+	};
+
+	MeshPool OGLU_API MakeMeshPool(const VertexAttribute* topology, size_t topologySize, size_t vertexCapacity = 0, size_t indexCapacity = 0, GLenum indexType = GL_UNSIGNED_INT);
+}
+
+#endif
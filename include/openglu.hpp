@@ -9,8 +9,24 @@
 #define OPENGLU_HPP
 
 #include <color.hpp>
+#include <buffer.hpp>
 #include <vertexArray.hpp>
+#include <meshPool.hpp>
+#include <mesh.hpp>
+#include <meshCache.hpp>
+#include <meshOptimizer.hpp>
+#include <vertexCompression.hpp>
 #include <shader.hpp>
+#include <shaderReflection.hpp>
+#include <computeShader.hpp>
+#include <pipeline.hpp>
+#include <shaderVariants.hpp>
+#include <shaderWarmUp.hpp>
+#include <stateTracker.hpp>
+#include <mappedFile.hpp>
+#include <uniformBuffer.hpp>
+#include <storageBuffer.hpp>
+#include <streamBuffer.hpp>
 #include <texture.hpp>
 #include <object.hpp>
 #include <material.hpp>
@@ -32,6 +48,26 @@ namespace oglu
 	 */
 	OGLU_API void LoadGLLoader(GLADloadproc proc);
 
+	/**
+	 * @brief Checks if the current context supports an extension.
+	 * 
+	 * @param[in] name Name of the extension, e.g. GL_KHR_parallel_shader_compile
+	 * 
+	 * @returns True if the extension is supported.
+	 */
+	OGLU_API bool HasExtension(const char* name);
+
+	/**
+	 * @brief Looks up an OpenGL function through the loader passed to LoadGLLoader.
+	 * 
+	 * Used for extension functions that the bundled loader does not know about.
+	 * 
+	 * @param[in] name Name of the function
+	 * 
+	 * @returns Address of the function, or nullptr if it isn't available.
+	 */
+	OGLU_API void* GetGLProcAddress(const char* name);
+
 	/**
 	 * @brief Wrapper of glViewport.
 	 * 
@@ -0,0 +1,141 @@
+/*****************************************************************//**
+ * \file   pipeline.hpp
+ * \brief  Program pipelines combining separable programs
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <core.hpp>
+#include <shader.hpp>
+
+#include <array>
+
+namespace oglu
+{
+	class AbstractPipeline;
+
+	typedef std::shared_ptr<AbstractPipeline> Pipeline;
+
+	/**
+	 * @brief An object representing an OpenGL Program Pipeline.
+	 *
+	 * A pipeline combines separable programs (see MakeShaderStage()) that were linked
+	 * on their own, so every combination of stages can be drawn without linking a
+	 * program for it. The pipeline keeps its programs alive.
+	 *
+	 * Uniforms are set on the program of the respective stage, see GetStage().
+	 * Using a program with AbstractShader::Use() overrides the pipeline, Bind()
+	 * takes care of that.
+	 *
+	 * This class cannot be instantiated, this should be done via MakePipeline().
+	 */
+	class OGLU_API AbstractPipeline
+	{
+	public:
+		/**
+		 * @brief Constructs a pipeline from separable programs.
+		 *
+		 * Pipelines are shared: requesting the same programs again returns the existing
+		 * pipeline for as long as it is alive, independent of the order of @p stages.
+		 * Requires OpenGL 4.1.
+		 *
+		 * @param[in] stages Array of separable programs, no two may contain the same stage
+		 * @param[in] stagesSize Size of the stages array
+		 *
+		 * @throws std::runtime_error If a program isn't separable or two programs contain the same stage
+		 *
+		 * @return A shared pointer to the pipeline.
+		 */
+		friend Pipeline OGLU_API MakePipeline(const Shader* stages, size_t stagesSize);
+
+		AbstractPipeline(const AbstractPipeline& other) = delete;
+		~AbstractPipeline();
+
+		/**
+		 * @brief Stop using any program and bind this pipeline.
+		 */
+		void Bind();
+
+		/**
+		 * @brief Unbind the pipeline.
+		 */
+		void Unbind();
+
+		/**
+		 * @brief Check if the stages of this pipeline fit together in the current state.
+		 *
+		 * Problems (e.g. mismatching interfaces between stages) are written to the error stream.
+		 *
+		 * @return True if the pipeline can be drawn with.
+		 */
+		bool Validate();
+
+		/**
+		 * @brief Get the program providing a stage.
+		 *
+		 * @param[in] type Type of the stage, e.g. GL_FRAGMENT_SHADER
+		 *
+		 * @return The program, or nullptr if the pipeline has no such stage.
+		 */
+		Shader GetStage(GLenum type) const;
+
+		/**
+		 * @brief Get the stages of this pipeline.
+		 *
+		 * @return A bitfield of GL_*_SHADER_BIT values.
+		 */
+		GLbitfield GetStages() const;
+
+	private:
+		typedef std::array<GLuint, 6> StageKey;	///< Program of every stage slot
+
+		/**
+		 * @brief Construct a program pipeline.
+		 *
+		 * To avoid accidental deletion of pipelines while they're still in use,
+		 * this constructor has been made private. To create a pipeline use
+		 * MakePipeline().
+		 *
+		 * @param[in] programs Program of every stage slot, may contain nullptr
+		 * @param[in] key Handles of the programs, the key of the pipeline among the live pipelines
+		 */
+		AbstractPipeline(const std::array<Shader, 6>& programs, const StageKey& key);
+
+		/**
+		 * @brief Sorts programs into stage slots.
+		 *
+		 * @param[in] stages Array of separable programs
+		 * @param[in] stagesSize Amount of programs
+		 * @param[out] programs Program of every stage slot
+		 * @param[out] key Handle of the program of every stage slot
+		 *
+		 * @throws std::runtime_error If a program isn't separable or two programs contain the same stage
+		 */
+		static void SortStages(const Shader* stages, size_t stagesSize, std::array<Shader, 6>& programs, StageKey& key);
+
+	private:
+		GLuint pipeline;					///< Handle to the OpenGL program pipeline
+		std::array<Shader, 6> programs;		///< Program of every stage slot
+		StageKey key;						///< Key of the pipeline among the live pipelines
+		GLbitfield stages;					///< Stages of the pipeline
+	};
+
+	Pipeline OGLU_API MakePipeline(const Shader* stages, size_t stagesSize);
+
+	/**
+	 * @brief Constructs a pipeline from a separable vertex and fragment program.
+	 *
+	 * @param[in] vertexStage Separable program containing the vertex stage
+	 * @param[in] fragmentStage Separable program containing the fragment stage
+	 *
+	 * @throws std::runtime_error If a program isn't separable or both programs contain the same stage
+	 *
+	 * @return A shared pointer to the pipeline.
+	 */
+	Pipeline OGLU_API MakePipeline(const Shader& vertexStage, const Shader& fragmentStage);
+}
+
+#endif
@@ -10,6 +10,13 @@
 #define SHADER_HPP
 
 #include <core.hpp>
+#include <shaderReflection.hpp>
+#include <hash.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <type_traits>
 
 namespace oglu
 {
@@ -21,8 +28,222 @@ namespace oglu
 	typedef std::shared_ptr<AbstractTexture> Texture;
 
 	class AbstractShader;
+	class AbstractPendingShader;
+	struct ShaderStageSource;
 
 	typedef std::shared_ptr<AbstractShader> Shader;
+	typedef std::shared_ptr<AbstractPendingShader> PendingShader;
+
+	/**
+	 * @brief A preprocessor definition that is injected into shader sources.
+	 */
+	struct OGLU_API ShaderDefine
+	{
+		/*@{*/
+		const char* name;	///< Name of the macro
+		const char* value;	///< Value of the macro, may be nullptr
+		/*@}*/
+	};
+
+	/**
+	 * @brief A shader file that is compiled into the application.
+	 * 
+	 * Tables of these are generated from shader files at build time by the
+	 * `oglu_embed_shaders()` CMake function.
+	 */
+	struct OGLU_API EmbeddedShaderFile
+	{
+		/*@{*/
+		const char* name;	///< Path of the file relative to the directory it was embedded from, e.g. "shaders/lighting.glsl"
+		const char* data;	///< Contents of the file
+		size_t size;		///< Size of the contents in bytes
+		/*@}*/
+	};
+
+	/**
+	 * @brief The value of a specialization constant of a SPIR-V module.
+	 * 
+	 * Constants are 32 bit scalars, floats have to be passed as their bit pattern
+	 * and booleans as 0 or 1.
+	 */
+	struct OGLU_API ShaderSpecialization
+	{
+		/*@{*/
+		GLuint index;	///< The constant_id of the constant
+		GLuint value;	///< Value to specialize the constant with
+		/*@}*/
+	};
+
+	/**
+	 * @brief A single stage of a shader program.
+	 */
+	struct OGLU_API ShaderStage
+	{
+		/*@{*/
+		GLenum type;		///< Type of the stage, e.g. GL_GEOMETRY_SHADER or GL_TESS_CONTROL_SHADER
+		const char* file;	///< Filepath to the source of the stage
+		/*@}*/
+	};
+
+	/**
+	 * @brief Source files of a shader program, used by MakeShaders().
+	 * 
+	 * Members that aren't needed can be left out of the initializer.
+	 * 
+	 * Every file may either be GLSL source or a SPIR-V module, which is detected by
+	 * its magic number. SPIR-V modules skip the GLSL front end entirely: they aren't
+	 * preprocessed, the defines don't apply to them and their entry point has to be
+	 * called `main`. Instead they are specialized with the specializations.
+	 * SPIR-V requires OpenGL 4.6 or GL_ARB_gl_spirv.
+	 */
+	struct OGLU_API ShaderFiles
+	{
+		/*@{*/
+		const char* vertexShaderFile;	///< Filepath to the vertex shader, may be nullptr
+		const char* fragmentShaderFile;	///< Filepath to the fragment shader, may be nullptr
+		const ShaderDefine* defines;	///< Definitions injected into all stages, may be nullptr
+		size_t definesSize;				///< Size of the defines array
+		const ShaderStage* stages;		///< Additional stages, e.g. geometry, tessellation or compute, may be nullptr
+		size_t stagesSize;				///< Size of the stages array
+		bool separable;					///< Link a separable program that can be combined with others in a pipeline, see MakePipeline()
+		const ShaderSpecialization* specializations;	///< Specialization constants applied to all SPIR-V stages, may be nullptr
+		size_t specializationsSize;						///< Size of the specializations array
+		const EmbeddedShaderFile* embeddedFiles;		///< Table all files and includes are taken from instead of the disk, may be nullptr
+		size_t embeddedFilesSize;						///< Size of the embeddedFiles array
+		/*@}*/
+	};
+
+	/**
+	 * @brief A uniform name with its precomputed hash.
+	 * 
+	 * The hash is the same 64 bit FNV-1a hash the uniform location table of a
+	 * shader uses, so AbstractShader::GetUniformLocation(UniformID id) can probe
+	 * the table directly. Create them with OGLU_UNIFORM(), which always hashes
+	 * the name at compile time:
+	 * 
+	 * @code
+	 * shader->SetUniform(OGLU_UNIFORM("material.shininess"), 32.0f);
+	 * @endcode
+	 * 
+	 * The _uniform literal is shorter, but like every constexpr function it is only
+	 * guaranteed to run at compile time in a constant expression. Used directly as an
+	 * argument the hash is computed at runtime unless the optimizer folds it, so store
+	 * it in a constexpr variable instead:
+	 * 
+	 * @code
+	 * using namespace oglu::literals;
+	 * static constexpr oglu::UniformID shininess = "material.shininess"_uniform;
+	 * shader->SetUniform(shininess, 32.0f);
+	 * @endcode
+	 */
+	struct OGLU_API UniformID
+	{
+		/*@{*/
+		uint64_t hash;			///< FNV-1a hash of the name
+		const GLchar* name;		///< The name, used if the table doesn't know the uniform yet
+		size_t length;			///< Length of the name
+		/*@}*/
+
+		/**
+		 * @brief Hashes a name.
+		 * 
+		 * @param[in] name Name of the uniform, must outlive the UniformID. It doesn't have to be NUL-terminated
+		 * @param[in] length Length of @p name
+		 */
+		constexpr UniformID(const GLchar* name, size_t length) :
+			hash(Hash(name, length)), name(name), length(length)
+		{
+		}
+
+		/**
+		 * @brief Takes a name that was already hashed.
+		 * 
+		 * @param[in] hash Hash of @p name, as computed by Hash()
+		 * @param[in] name Name of the uniform, must outlive the UniformID. It doesn't have to be NUL-terminated
+		 * @param[in] length Length of @p name
+		 */
+		constexpr UniformID(uint64_t hash, const GLchar* name, size_t length) :
+			hash(hash), name(name), length(length)
+		{
+		}
+
+		/**
+		 * @brief 64 bit FNV-1a hash of a name.
+		 */
+		static constexpr uint64_t Hash(const GLchar* name, size_t length)
+		{
+			uint64_t hash = FNV_OFFSET_BASIS;
+			for (size_t i = 0; i < length; i++)
+			{
+				hash ^= (unsigned char)name[i];
+				hash *= FNV_PRIME;
+			}
+
+			return hash;
+		}
+	};
+
+	namespace literals
+	{
+		/**
+		 * @brief Creates a UniformID.
+		 * 
+		 * The name is only hashed at compile time if the result is used in a constant
+		 * expression, e.g. to initialize a constexpr variable. See OGLU_UNIFORM().
+		 */
+		constexpr UniformID operator""_uniform(const char* name, size_t length)
+		{
+			return UniformID(name, length);
+		}
+	}
+
+	/**
+	 * @brief Creates a UniformID from a string literal, hashed at compile time in every build configuration.
+	 *
+	 * The hash is a template argument, which forces the compiler to evaluate it.
+	 */
+#define OGLU_UNIFORM(name) ::oglu::UniformID(std::integral_constant<uint64_t, ::oglu::UniformID::Hash(name, sizeof(name) - 1)>::value, name, sizeof(name) - 1)
+
+	/**
+	 * @brief Counters of the uniform location cache of a shader.
+	 * 
+	 * A hit is a lookup that was answered by the cache, a miss is a lookup
+	 * that had to be forwarded to the driver via glGetUniformLocation.
+	 */
+	struct OGLU_API UniformCacheStats
+	{
+		/*@{*/
+		unsigned long long hits;	///< Lookups served by the cache
+		unsigned long long misses;	///< Lookups that queried the driver
+		/*@}*/
+	};
+
+	/**
+	 * @brief Counters of uniform uploads of a shader.
+	 * 
+	 * With uniform shadowing enabled, uploads of values the program already holds
+	 * are skipped. Reset these counters every frame to get per-frame numbers.
+	 */
+	struct OGLU_API UniformUploadStats
+	{
+		/*@{*/
+		unsigned long long issued;	///< Uploads forwarded to OpenGL
+		unsigned long long skipped;	///< Uploads dropped because the value didn't change
+		/*@}*/
+	};
+
+	/**
+	 * @brief Information about how a shader program was created.
+	 */
+	struct OGLU_API ShaderLoadInfo
+	{
+		/*@{*/
+		bool fromCache;			///< The program was loaded from the shader cache
+		bool cacheRejected;		///< A cache entry existed but the driver rejected it
+		double milliseconds;	///< Time spent loading the binary, or compiling, linking and querying the status of the program
+		double latency;			///< Time in milliseconds from submitting the program until Get() returned it, includes whatever the application did in between
+		/*@}*/
+	};
 
 	/**
 	 * @brief An object representing an OpenGL Shader Program.
@@ -38,14 +259,26 @@ namespace oglu
 		/**
 		 * @brief Constructs a new shader program.
 		 * 
-		 * Use this function to create new shaders.
+		 * Use this function to create new shaders. Both sources are memory mapped and
+		 * run through the preprocessor first, so they may use `#include` (see AddShaderIncludePath()).
+		 * Included files aren't deduplicated, shared ones need an include guard.
+		 * The @p defines are inserted after the `#version` directive of both stages.
+		 * Either file may also be a precompiled SPIR-V module, see ShaderFiles.
+		 * 
+		 * Programs are shared: requesting the same sources with the same defines again
+		 * returns the existing program for as long as it is alive.
 		 * 
 		 * @param[in] vertexShaderFile Filepath to the vertex shader
 		 * @param[in] fragmentShaderFile Filepath to the fragment shader
+		 * @param[in] defines Array of definitions to inject
+		 * @param[in] definesSize Size of the defines array
 		 * 
 		 * @return A shared pointer to the shader program.
 		 */
-		friend Shader OGLU_API MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile);
+		friend Shader OGLU_API MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile, const ShaderDefine* defines, size_t definesSize);
+
+		friend class AbstractPendingShader;
+		friend class AbstractPipeline;
 		
 		/**
 		 * @brief Copy constructor.
@@ -63,15 +296,142 @@ namespace oglu
 		 */
 		void Use();
 
+		/**
+		 * @brief Bind a uniform block of this program to a binding point.
+		 * 
+		 * Every program that binds a block to the same point reads from the buffer
+		 * bound there, see AbstractUniformBuffer::BindBase().
+		 * 
+		 * @param[in] name Name of the uniform block
+		 * @param[in] binding Index of the binding point
+		 */
+		void BindUniformBlock(const GLchar* name, GLuint binding);
+
+		/**
+		 * @brief Bind a shader storage block of this program to a binding point.
+		 * 
+		 * Every program that binds a block to the same point accesses the buffer
+		 * bound there, see AbstractStorageBuffer::BindBase().
+		 * 
+		 * @param[in] name Name of the storage block
+		 * @param[in] binding Index of the binding point
+		 */
+		void BindStorageBlock(const GLchar* name, GLuint binding);
+
 		/**
 		 * @brief Get the uniform location within the program.
 		 * 
+		 * All active uniforms (including struct members and array elements) are
+		 * enumerated after linking, so this is a lookup in a hash table. Names that
+		 * are not known to the table are queried from the driver once and then cached.
+		 * 
 		 * @param[in] name Name of the uniform
 		 * 
 		 * @return Location of the uniform.
 		 */
 		GLint GetUniformLocation(const GLchar* name);
 
+		/**
+		 * @brief Get the uniform location of a compile time hashed name.
+		 * 
+		 * The hash is looked up in the same table as GetUniformLocation(const GLchar* name),
+		 * the name itself is only read if two active uniforms share a hash or if the
+		 * uniform isn't known to the table yet.
+		 * 
+		 * @param[in] id Hashed name of the uniform, see operator""_uniform()
+		 * 
+		 * @return Location of the uniform.
+		 */
+		GLint GetUniformLocation(UniformID id);
+
+		/**
+		 * @brief Get the hit and miss counters of the uniform location cache.
+		 * 
+		 * @return The counters accumulated since creation or the last reset.
+		 */
+		const UniformCacheStats& GetUniformCacheStats() const;
+
+		/**
+		 * @brief Reset the hit and miss counters of the uniform location cache.
+		 */
+		void ResetUniformCacheStats();
+
+		/**
+		 * @brief Toggle the shadow copy of this program's uniforms.
+		 * 
+		 * When enabled, the shader keeps a copy of the uniform storage of the program and
+		 * compares every upload against it. If the value didn't change the upload is skipped.
+		 * The copy is initialized with the current values of the program when it is enabled.
+		 * Uniforms set with raw OpenGL calls bypass the copy, so don't mix the two.
+		 * Copies of a shader use the same program, so they share the shadow copy and this setting.
+		 * 
+		 * @param[in] enable Wether to enable shadowing
+		 */
+		void SetUniformShadowing(bool enable);
+
+		/**
+		 * @brief Get the counters of issued and skipped uniform uploads.
+		 * 
+		 * @return The counters accumulated since creation or the last reset.
+		 */
+		const UniformUploadStats& GetUniformUploadStats() const;
+
+		/**
+		 * @brief Reset the counters of issued and skipped uniform uploads.
+		 */
+		void ResetUniformUploadStats();
+
+		/**
+		 * @brief Toggle direct state access for uniform uploads.
+		 * 
+		 * When enabled, uniforms are set with glProgramUniform*, so this program doesn't
+		 * need to be in use. Uniforms of many programs can then be staged without switching
+		 * programs, and Use() only has to be called right before drawing.
+		 * Requires OpenGL 4.1, on older contexts it stays disabled.
+		 * 
+		 * @param[in] enable Wether to use direct state access
+		 */
+		void SetDirectStateAccess(bool enable);
+
+		/**
+		 * @brief Check wether uniforms are uploaded with direct state access.
+		 */
+		bool GetDirectStateAccess() const;
+
+		/**
+		 * @brief Get information about how this program was created.
+		 * 
+		 * This reports wether the program came from the shader cache and how long creating it took.
+		 * Also see: SetShaderCacheDirectory()
+		 * 
+		 * @return Load information of this program.
+		 */
+		const ShaderLoadInfo& GetLoadInfo() const;
+
+		/**
+		 * @brief Get the stages linked into this program.
+		 * 
+		 * @return A bitfield of GL_*_SHADER_BIT values.
+		 */
+		GLbitfield GetStages() const;
+
+		/**
+		 * @brief Check wether this program was linked as a separable program.
+		 * 
+		 * Separable programs are combined in a pipeline instead of being used directly,
+		 * see MakePipeline(). They always upload uniforms with direct state access.
+		 */
+		bool IsSeparable() const;
+
+		/**
+		 * @brief Get everything this program consumes.
+		 * 
+		 * The reflection is built once after linking and shared between copies of the shader.
+		 * 
+		 * @return The attributes, uniforms and blocks of this program.
+		 */
+		const ShaderReflection& GetReflection() const;
+
 #pragma region Uniforms
 		/**
 		 * @brief Set uniform float.
@@ -756,34 +1116,387 @@ namespace oglu
 		 * @param[in] value Values to set uniforms to
 		 */
 		void SetUniformMatrix4x3fv(GLint location,		GLsizei count, GLboolean transpose, const GLfloat* value);
+		/**
+		 * @name Compile time hashed overloads
+		 * 
+		 * Every setter also accepts a UniformID, e.g. `shader->SetUniform("model"_uniform, cube)`.
+		 * The name was hashed by the compiler, so the location is found in the
+		 * per-program table without hashing or comparing strings at runtime.
+		 */
+		/*@{*/
+		void SetUniform(UniformID id, GLfloat v0);
+		void SetUniform(UniformID id, GLfloat v0, GLfloat v1);
+		void SetUniform(UniformID id, GLfloat v0, GLfloat v1, GLfloat v2);
+		void SetUniform(UniformID id, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+		void SetUniform(UniformID id, GLint v0);
+		void SetUniform(UniformID id, GLint v0, GLint v1);
+		void SetUniform(UniformID id, GLint v0, GLint v1, GLint v2);
+		void SetUniform(UniformID id, GLint v0, GLint v1, GLint v2, GLint v3);
+		void SetUniform(UniformID id, GLuint v0);
+		void SetUniform(UniformID id, GLuint v0, GLuint v1);
+		void SetUniform(UniformID id, GLuint v0, GLuint v1, GLuint v2);
+		void SetUniform(UniformID id, GLuint v0, GLuint v1, GLuint v2, GLuint v3);
+		void SetUniform(UniformID id, const Color& v0, bool ignoreAlpha = false);
+		void SetUniformTexture(UniformID id, const Texture& v0, GLbyte index = 0);
+		void SetUniform(UniformID id, Transformable& v0, GLboolean transpose = GL_FALSE);
+		void SetUniform1fv(UniformID id, GLsizei count, const GLfloat* value);
+		void SetUniform2fv(UniformID id, GLsizei count, const GLfloat* value);
+		void SetUniform3fv(UniformID id, GLsizei count, const GLfloat* value);
+		void SetUniform4fv(UniformID id, GLsizei count, const GLfloat* value);
+		void SetUniform1iv(UniformID id, GLsizei count, const GLint* value);
+		void SetUniform2iv(UniformID id, GLsizei count, const GLint* value);
+		void SetUniform3iv(UniformID id, GLsizei count, const GLint* value);
+		void SetUniform4iv(UniformID id, GLsizei count, const GLint* value);
+		void SetUniform1uiv(UniformID id, GLsizei count, const GLuint* value);
+		void SetUniform2uiv(UniformID id, GLsizei count, const GLuint* value);
+		void SetUniform3uiv(UniformID id, GLsizei count, const GLuint* value);
+		void SetUniform4uiv(UniformID id, GLsizei count, const GLuint* value);
+		void SetUniformMatrix2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix2x3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix3x2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix2x4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix4x2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix3x4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		void SetUniformMatrix4x3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value);
+		/*@}*/
 #pragma endregion Uniforms
 
-	private:
+	protected:
 		/**
 		 * @brief Construct a shader program.
 		 * 
 		 * To avoid accidental deletion of shader programs while they're still in use, 
-		 * this constructor has been made private. To create a shader program use
+		 * this constructor has been made protected. To create a shader program use
 		 * MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile).
 		 * 
-		 * @param[in] vertexShaderFile Filepath to the vertex shader
-		 * @param[in] fragmentShaderFile Filepath to the fragment shader
+		 * @param[in] program Handle to a successfully linked program, the shader takes ownership of it
+		 * @param[in] loadInfo Information about how the program was created
+		 */
+		AbstractShader(GLuint program, const ShaderLoadInfo& loadInfo);
+
+	private:
+		/**
+		 * @brief Fills the uniform location cache with every active uniform of the reflection.
 		 */
-		AbstractShader(const char* vertexShaderFile, const char* fragmentShaderFile);
+		void BuildUniformCache();
 
 		/**
-		 * @brief Loads a shader file from disk
-		 *
-		 * @param[in] filename Filepath to the shader
-		 * @param[out] buffer Contents of the shader file
+		 * @brief Adds a name to the uniform location cache.
+		 * 
+		 * @param[in] name Name of the uniform
+		 * @param[in] length Length of @p name
+		 * @param[in] hash Hash of @p name
+		 * @param[in] location Location to cache
 		 */
-		void LoadShaderSource(const char* filename, char** buffer);
+		void InsertUniformLocation(const GLchar* name, size_t length, uint64_t hash, GLint location);
+
+		/**
+		 * @brief Rehashes the uniform location cache into a table of the given capacity.
+		 * 
+		 * @param[in] capacity New amount of slots, must be a power of two
+		 */
+		void ResizeUniformCache(size_t capacity);
+
+		/**
+		 * @brief Compares an upload against the shadow copy and updates it.
+		 * 
+		 * @param[in] location Location of the uniform
+		 * @param[in] data Values that are about to be uploaded
+		 * @param[in] size Size of @p data in bytes
+		 * 
+		 * @return False if the upload can be skipped.
+		 */
+		inline bool ShouldUpload(GLint location, const void* data, size_t size);
+
+		/**
+		 * @brief Compares a matrix upload against the shadow copy and updates it.
+		 * 
+		 * @param[in] location Location of the uniform
+		 * @param[in] count Amount of matrices
+		 * @param[in] transpose Wether the matrices are supplied in row major order
+		 * @param[in] columns Amount of columns of a matrix
+		 * @param[in] rows Amount of rows of a matrix
+		 * @param[in] value Matrices that are about to be uploaded
+		 * 
+		 * @return False if the upload can be skipped.
+		 */
+		bool ShouldUploadMatrix(GLint location, GLsizei count, GLboolean transpose, int columns, int rows, const GLfloat* value);
+
+		/**
+		 * @brief An element of an active uniform, arrays have one element per entry.
+		 */
+		struct UniformElement
+		{
+			GLint location;		///< Location of the element
+			GLenum type;		///< Type of the uniform
+			GLint remaining;	///< Amount of array elements from this one to the end of the array
+		};
+
+		/**
+		 * @brief Region of the shadow copy that belongs to a location.
+		 */
+		struct ShadowSlot
+		{
+			GLuint offset;		///< Offset into UniformShadow::storage
+			GLuint size;		///< Bytes from the offset to the end of the uniform, 0 if not shadowed
+		};
+
+		/**
+		 * @brief Shadow copy of the uniform values of a program.
+		 */
+		struct UniformShadow
+		{
+			bool enabled;						///< Wether uploads are compared to the shadow copy
+			std::vector<ShadowSlot> slots;		///< Shadow regions indexed by location
+			std::vector<unsigned char> storage;	///< Shadow copy of the uniform values
+		};
+
+		/**
+		 * @brief A slot in the open addressing uniform location table.
+		 */
+		struct UniformSlot
+		{
+			uint64_t hash;			///< FNV-1a hash of the name
+			GLint location;			///< Cached location
+			GLuint nameOffset;		///< Offset of the name into uniformNames
+			GLuint nameLength;		///< Length of the name, 0 marks an empty slot
+		};
 
 	private:
 		GLuint program;	///< Handle to the Shader program
+		std::shared_ptr<const ShaderReflection> reflection;	///< Interface of the program
+
+		std::vector<UniformSlot> uniformSlots;	///< Open addressing table, capacity is a power of two
+		std::vector<GLchar> uniformNames;		///< Storage for the names referenced by uniformSlots
+		size_t uniformCount;					///< Amount of occupied slots
+		bool uniformHashCollision;				///< Two names in the table share a hash
+		UniformCacheStats uniformCacheStats;	///< Hit and miss counters
+		ShaderLoadInfo loadInfo;				///< How this program was created
+		GLbitfield stages;						///< Stages linked into the program
+		bool separable;							///< Wether the program is separable
+
+		std::vector<UniformElement> uniformElements;	///< Every active uniform element in the default block
+		std::shared_ptr<UniformShadow> uniformShadow;	///< Shadow copy, shared with copies of this shader since they use the same program
+		bool directStateAccess;							///< Wether uploads use glProgramUniform*
+		UniformUploadStats uniformUploadStats;			///< Issued and skipped uploads
 	};
 
-	Shader OGLU_API MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile);
+	/**
+	 * @brief A shader program that is still being compiled.
+	 * 
+	 * MakeShaders() submits the compilation and linking of many programs at once and
+	 * returns one of these handles per program. The status of the program is only
+	 * queried once it is requested, so the driver can compile in the background
+	 * (especially if GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+	 * are supported) while the application loads textures and meshes.
+	 * 
+	 * This class cannot be instantiated, this should be done via MakeShaders().
+	 */
+	class OGLU_API AbstractPendingShader
+	{
+	public:
+		/**
+		 * @brief Submits the compilation of many shader programs.
+		 * 
+		 * All stages of all programs are compiled and linked before any status is queried.
+		 * The source files are memory mapped and handed to the driver piece by piece,
+		 * they are never copied, not even when they include other files.
+		 * Programs found in the shader cache, and programs with the same preprocessed sources
+		 * as a program that is still alive, are ready immediately.
+		 * 
+		 * @param[in] shaders Array of ShaderFiles
+		 * @param[in] shadersSize Size of the shaders array
+		 * 
+		 * @return A handle per program, in the same order as @p shaders.
+		 */
+		friend std::vector<PendingShader> OGLU_API MakeShaders(const ShaderFiles* shaders, size_t shadersSize);
+
+		AbstractPendingShader(const AbstractPendingShader& other) = delete;
+		~AbstractPendingShader();
+
+		/**
+		 * @brief Check if the program finished compiling without blocking.
+		 * 
+		 * Without parallel shader compilation support the driver can't be asked
+		 * without blocking, in that case this always returns true.
+		 * 
+		 * @return True if Get() won't wait for the driver.
+		 */
+		bool IsReady();
+
+		/**
+		 * @brief Get the finished shader program.
+		 * 
+		 * Waits for the driver if the program isn't ready yet. Subsequent calls return the same shader.
+		 * 
+		 * @throws std::runtime_error If a stage failed to compile or the program failed to link
+		 * 
+		 * @return A shared pointer to the shader program.
+		 */
+		Shader Get();
+
+	private:
+		/**
+		 * @brief Tries to load the program from the shader cache.
+		 * 
+		 * @param[in] stages Preprocessed sources of all stages
+		 * @param[in] variantKey Hash of all preprocessed sources
+		 * @param[in] separable Wether to link a separable program
+		 */
+		AbstractPendingShader(std::vector<ShaderStageSource>&& stages, uint64_t variantKey, bool separable);
+
+		/**
+		 * @brief Builds the error message of a stage that failed to compile.
+		 * 
+		 * @param[in] stage The stage that failed
+		 */
+		std::string GetCompileError(const ShaderStageSource& stage);
+
+		/**
+		 * @brief Creates and compiles all stages without querying their status, then unmaps the sources.
+		 */
+		void SubmitCompile();
+
+		/**
+		 * @brief Attaches all stages and links the program without querying its status.
+		 */
+		void SubmitLink();
+
+		/**
+		 * @brief Deletes all OpenGL objects that are still owned by this object.
+		 */
+		void Release();
+
+	private:
+		std::vector<ShaderStageSource> stages;	///< Sources and shader objects of all stages
+		uint64_t variantKey;			///< Key of the program among the live variants
+		bool separable;					///< Wether the program is linked as a separable program
+
+		GLuint program;					///< Handle to the program
+
+		std::string cacheFile;			///< Path of the shader cache entry, empty if caching is disabled
+		uint64_t cacheKey;				///< Key of the shader cache entry
+		ShaderLoadInfo loadInfo;		///< How the program was created
+		double startTime;				///< Time the request was submitted, in milliseconds, to measure the latency
+
+		Shader shader;					///< The finished program
+		std::string error;				///< Error message if compiling or linking failed
+	};
+
+	Shader OGLU_API MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile, const ShaderDefine* defines = nullptr, size_t definesSize = 0);
+
+	/**
+	 * @brief Constructs a new shader program from an arbitrary set of stages.
+	 * 
+	 * Works like MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile),
+	 * but supports every pipeline stage, e.g. tessellation and geometry shaders.
+	 * 
+	 * @param[in] stages Array of stages
+	 * @param[in] stagesSize Size of the stages array
+	 * @param[in] defines Array of definitions to inject into every stage
+	 * @param[in] definesSize Size of the defines array
+	 * 
+	 * @throws std::runtime_error If a stage failed to compile or the program failed to link
+	 * 
+	 * @return A shared pointer to the shader program.
+	 */
+	Shader OGLU_API MakeShader(const ShaderStage* stages, size_t stagesSize, const ShaderDefine* defines = nullptr, size_t definesSize = 0);
+
+	/**
+	 * @brief Constructs a new shader program from a complete description.
+	 * 
+	 * This is the only overload that can pass specialization constants to SPIR-V stages.
+	 * 
+	 * @param[in] files Stages, definitions and specializations of the program
+	 * 
+	 * @throws std::runtime_error If a stage failed to compile or the program failed to link
+	 * 
+	 * @return A shared pointer to the shader program.
+	 */
+	Shader OGLU_API MakeShader(const ShaderFiles& files);
+
+	/**
+	 * @brief Constructs a new shader program from files that are embedded into the application.
+	 * 
+	 * Works like MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile), but
+	 * the files and everything they include are looked up in @p embeddedFiles, so no file is
+	 * read at all. Quoted includes are resolved relative to the including file first, then
+	 * relative to the root of the table, angled includes only relative to the root.
+	 * 
+	 * @param[in] embeddedFiles Table of embedded files, as generated by `oglu_embed_shaders()`
+	 * @param[in] embeddedFilesSize Size of the embeddedFiles array
+	 * @param[in] vertexShaderFile Name of the vertex shader in the table
+	 * @param[in] fragmentShaderFile Name of the fragment shader in the table
+	 * @param[in] defines Array of definitions to inject
+	 * @param[in] definesSize Size of the defines array
+	 * 
+	 * @throws std::runtime_error If a file isn't in the table, a stage failed to compile or the program failed to link
+	 * 
+	 * @return A shared pointer to the shader program.
+	 */
+	Shader OGLU_API MakeShaderFromMemory(const EmbeddedShaderFile* embeddedFiles, size_t embeddedFilesSize, const char* vertexShaderFile, const char* fragmentShaderFile, const ShaderDefine* defines = nullptr, size_t definesSize = 0);
+
+	/**
+	 * @brief Constructs a separable program consisting of a single stage.
+	 * 
+	 * Separable programs are linked once each and then combined in any way with
+	 * MakePipeline(), so N vertex and M fragment variants only need N + M links.
+	 * To build many stages at once, use MakeShaders() with ShaderFiles::separable set.
+	 * Requires OpenGL 4.1.
+	 * 
+	 * @param[in] type Type of the stage, e.g. GL_VERTEX_SHADER
+	 * @param[in] file Filepath to the source of the stage
+	 * @param[in] defines Array of definitions to inject
+	 * @param[in] definesSize Size of the defines array
+	 * 
+	 * @throws std::runtime_error If the stage failed to compile or link
+	 * 
+	 * @return A shared pointer to the separable program.
+	 */
+	Shader OGLU_API MakeShaderStage(GLenum type, const char* file, const ShaderDefine* defines = nullptr, size_t definesSize = 0);
+	std::vector<PendingShader> OGLU_API MakeShaders(const ShaderFiles* shaders, size_t shadersSize);
+
+	/**
+	 * @brief Set the directory of the shader cache.
+	 * 
+	 * When a cache directory is set, MakeShader() stores every linked program in it
+	 * via glGetProgramBinary. Later calls with the same sources on the same driver load the
+	 * binary instead of compiling, and fall back to compiling should the driver reject it.
+	 * The directory is created if it doesn't exist. Programs with SPIR-V stages aren't cached.
+	 * 
+	 * @param[in] directory Path to the cache directory, or nullptr to disable the cache
+	 */
+	void OGLU_API SetShaderCacheDirectory(const char* directory);
+
+	/**
+	 * @brief Add a directory that is searched for included shader files.
+	 * 
+	 * `#include "file"` is looked up relative to the including file first and then
+	 * in every include path in the order they were added, `#include <file>` only
+	 * uses the include paths. Includes are resolved before the driver sees the source,
+	 * without evaluating `#if`/`#ifdef`, so a file is pasted every time it is included,
+	 * including inside branches that end up disabled. Shared files therefore need their
+	 * own include guard (`#ifndef NAME` / `#define NAME` / `#endif`), which works with
+	 * defines-driven variants since the driver evaluates the conditionals.
+	 * 
+	 * @param[in] directory Path to the directory
+	 */
+	void OGLU_API AddShaderIncludePath(const char* directory);
+
+	/**
+	 * @brief Remove all include paths added with AddShaderIncludePath().
+	 */
+	void OGLU_API ClearShaderIncludePaths();
+
+	/**
+	 * @brief Check wether the driver can report the completion of a program without blocking.
+	 * 
+	 * This is the case if GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+	 * is supported. The first call also allows the driver to use as many compiler threads as it wants.
+	 */
+	bool OGLU_API SupportsParallelShaderCompile();
 }
 
 #endif
\ No newline at end of file
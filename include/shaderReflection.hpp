@@ -0,0 +1,163 @@
+/*****************************************************************//**
+ * \file   shaderReflection.hpp
+ * \brief  Information about the interface of a linked shader program
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef SHADERREFLECTION_HPP
+#define SHADERREFLECTION_HPP
+
+#include <core.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	/**
+	 * @brief An active vertex attribute of a program.
+	 */
+	struct OGLU_API ShaderAttributeInfo
+	{
+		/*@{*/
+		const GLchar* name;		///< Name of the attribute
+		GLint location;			///< Location of the attribute, -1 for built-ins
+		GLenum type;			///< Type of the attribute, e.g. GL_FLOAT_VEC3
+		GLint arraySize;		///< Amount of array elements, 1 for non-arrays
+		/*@}*/
+	};
+
+	/**
+	 * @brief An active uniform of a program.
+	 *
+	 * Struct members are listed individually, arrays appear once with the name of
+	 * their first element (e.g. "lights[0]").
+	 */
+	struct OGLU_API ShaderUniformInfo
+	{
+		/*@{*/
+		const GLchar* name;		///< Name of the uniform
+		GLint location;			///< Location of the uniform, -1 if it is part of a block
+		GLenum type;			///< Type of the uniform, e.g. GL_FLOAT_MAT4
+		GLint arraySize;		///< Amount of array elements, 1 for non-arrays
+		GLint blockIndex;		///< Index of the uniform block the uniform belongs to, -1 for the default block
+		GLint offset;			///< Offset within the block in bytes, -1 for the default block
+		GLint arrayStride;		///< Distance between array elements within the block in bytes
+		GLint matrixStride;		///< Distance between matrix columns (or rows) within the block in bytes
+		GLboolean rowMajor;		///< Wether a matrix in a block is stored row major
+		/*@}*/
+	};
+
+	/**
+	 * @brief An active uniform block or shader storage block of a program.
+	 */
+	struct OGLU_API ShaderBlockInfo
+	{
+		/*@{*/
+		const GLchar* name;		///< Name of the block
+		GLuint index;			///< Index of the block within the program
+		GLint binding;			///< Binding point the block was assigned when the program was linked
+		GLint dataSize;			///< Minimum size of a buffer backing the block in bytes
+		GLint activeMembers;	///< Amount of active members of the block
+		/*@}*/
+	};
+
+	/**
+	 * @brief Everything a linked program consumes.
+	 *
+	 * The reflection is queried once after the program is linked and stored in
+	 * flat arrays, so binding plans can be built at load time instead of looking
+	 * up names every frame. Storage blocks are only reported on OpenGL 4.3 or later.
+	 *
+	 * Use AbstractShader::GetReflection() to access the reflection of a program.
+	 */
+	class OGLU_API ShaderReflection
+	{
+	public:
+		friend class AbstractShader;
+
+		ShaderReflection(const ShaderReflection& other) = delete;
+
+		/**
+		 * @brief All active vertex attributes.
+		 */
+		const std::vector<ShaderAttributeInfo>& GetAttributes() const;
+
+		/**
+		 * @brief All active uniforms, including those in uniform blocks.
+		 */
+		const std::vector<ShaderUniformInfo>& GetUniforms() const;
+
+		/**
+		 * @brief All active uniform blocks, indexed by their block index.
+		 */
+		const std::vector<ShaderBlockInfo>& GetUniformBlocks() const;
+
+		/**
+		 * @brief All active shader storage blocks, indexed by their block index.
+		 */
+		const std::vector<ShaderBlockInfo>& GetStorageBlocks() const;
+
+		/**
+		 * @brief Find an attribute by name.
+		 *
+		 * @param[in] name Name of the attribute
+		 *
+		 * @return Pointer to the attribute, or nullptr if it isn't active.
+		 */
+		const ShaderAttributeInfo* FindAttribute(const GLchar* name) const;
+
+		/**
+		 * @brief Find a uniform by name.
+		 *
+		 * Arrays can be found by their name with or without "[0]".
+		 *
+		 * @param[in] name Name of the uniform
+		 *
+		 * @return Pointer to the uniform, or nullptr if it isn't active.
+		 */
+		const ShaderUniformInfo* FindUniform(const GLchar* name) const;
+
+		/**
+		 * @brief Find a uniform block by name.
+		 *
+		 * @param[in] name Name of the block
+		 *
+		 * @return Pointer to the block, or nullptr if it isn't active.
+		 */
+		const ShaderBlockInfo* FindUniformBlock(const GLchar* name) const;
+
+		/**
+		 * @brief Find a shader storage block by name.
+		 *
+		 * @param[in] name Name of the block
+		 *
+		 * @return Pointer to the block, or nullptr if it isn't active.
+		 */
+		const ShaderBlockInfo* FindStorageBlock(const GLchar* name) const;
+
+	private:
+		/**
+		 * @brief Queries the interface of a program.
+		 *
+		 * @param[in] program Handle to a successfully linked program
+		 */
+		ShaderReflection(GLuint program);
+
+		/**
+		 * @brief Stores a name in the name pool.
+		 *
+		 * @return Offset of the name into names.
+		 */
+		size_t AddName(const GLchar* name, GLsizei length);
+
+	private:
+		std::vector<ShaderAttributeInfo> attributes;	///< Active attributes
+		std::vector<ShaderUniformInfo> uniforms;		///< Active uniforms
+		std::vector<ShaderBlockInfo> uniformBlocks;		///< Active uniform blocks
+		std::vector<ShaderBlockInfo> storageBlocks;		///< Active shader storage blocks
+		std::vector<GLchar> names;						///< Storage for all names, never resized after construction
+	};
+}
+
+#endif
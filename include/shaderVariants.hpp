@@ -0,0 +1,142 @@
+/*****************************************************************//**
+ * \file   shaderVariants.hpp
+ * \brief  Background compilation of shader variants
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef SHADERVARIANTS_HPP
+#define SHADERVARIANTS_HPP
+
+#include <core.hpp>
+#include <shader.hpp>
+
+#include <vector>
+#include <unordered_map>
+
+namespace oglu
+{
+	class AbstractShaderVariants;
+
+	typedef std::shared_ptr<AbstractShaderVariants> ShaderVariants;
+
+	/**
+	 * @brief Define permutations of a shader program that are built on demand.
+	 *
+	 * The program built from the base description is the generic uber program. It
+	 * should handle every feature at runtime (e.g. by branching on uniforms) and
+	 * is used as long as a specialized variant isn't finished yet. Requesting a variant
+	 * never blocks: its compilation is submitted and the uber program is returned until
+	 * Update() finds the variant linked, after which the variant is returned instead.
+	 *
+	 * With GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile the driver
+	 * compiles in the background and variants are swapped in once they are done. Without
+	 * it the driver can't be asked without waiting, so Update() finishes at most one
+	 * variant per call, one frame after it was requested.
+	 *
+	 * Since every variant is its own program, uniforms have to be set on the program
+	 * returned by Get() each frame.
+	 *
+	 * This class cannot be instantiated, this should be done via MakeShaderVariants().
+	 */
+	class OGLU_API AbstractShaderVariants
+	{
+	public:
+		/**
+		 * @brief Constructs a variant set and builds its uber program.
+		 *
+		 * The description is copied, so the arrays and strings it points to don't have
+		 * to outlive this call. The only exception is the table of embedded files.
+		 *
+		 * @param[in] files Stages and base definitions shared by all variants
+		 *
+		 * @throws std::runtime_error If the uber program failed to build
+		 *
+		 * @return A shared pointer to the variant set.
+		 */
+		friend ShaderVariants OGLU_API MakeShaderVariants(const ShaderFiles& files);
+
+		AbstractShaderVariants(const AbstractShaderVariants& other) = delete;
+
+		/**
+		 * @brief Get the best program for a define permutation without blocking.
+		 *
+		 * The first request of a permutation submits its compilation. If the
+		 * variant failed to build, the error is reported once and the uber
+		 * program is used from then on.
+		 *
+		 * @param[in] defines Definitions added to the base definitions
+		 * @param[in] definesSize Size of the defines array
+		 *
+		 * @return The specialized variant if it is finished, otherwise the uber program.
+		 */
+		Shader Get(const ShaderDefine* defines, size_t definesSize);
+
+		/**
+		 * @brief Finish the variants whose compilation completed.
+		 *
+		 * Call this once per frame.
+		 */
+		void Update();
+
+		/**
+		 * @brief Get the generic program.
+		 */
+		const Shader& GetUberShader() const;
+
+		/**
+		 * @brief Get the amount of variants that were requested but aren't finished yet.
+		 */
+		size_t GetPendingCount() const;
+
+	private:
+		/**
+		 * @brief A requested define permutation.
+		 */
+		struct Variant
+		{
+			PendingShader pending;			///< The program while it is being built
+			Shader shader;					///< The finished program, nullptr while pending or if it failed
+			unsigned long long requested;	///< Value of frame when the variant was requested
+		};
+
+		/**
+		 * @brief Construct a variant set.
+		 *
+		 * To avoid accidental deletion of programs while they're still in use,
+		 * this constructor has been made private. To create a variant set use
+		 * MakeShaderVariants().
+		 *
+		 * @param[in] files Stages and base definitions shared by all variants
+		 */
+		AbstractShaderVariants(const ShaderFiles& files);
+
+		/**
+		 * @brief Builds a description of the program from the stored copy.
+		 *
+		 * @param[in,out] defines Receives the base definitions followed by @p extraDefines
+		 * @param[in] extraDefines Definitions of the variant
+		 * @param[in] extraDefinesSize Number of definitions of the variant
+		 */
+		ShaderFiles GetFiles(std::vector<ShaderDefine>& defines, const ShaderDefine* extraDefines, size_t extraDefinesSize) const;
+
+	private:
+		std::string vertexShaderFile;							///< Filepath to the vertex shader
+		std::string fragmentShaderFile;							///< Filepath to the fragment shader
+		std::vector<std::string> stageFiles;					///< Filepaths of the additional stages
+		std::vector<ShaderStage> stages;						///< Additional stages, pointing into stageFiles
+		std::vector<std::string> defineStrings;					///< Names and values of the base definitions
+		std::vector<ShaderSpecialization> specializations;		///< Specialization constants of SPIR-V stages
+		bool separable;											///< Wether the programs are separable
+		const EmbeddedShaderFile* embeddedFiles;				///< Table of embedded files, not copied
+		size_t embeddedFilesSize;								///< Size of the embeddedFiles array
+
+		Shader uberShader;										///< The generic program
+		std::unordered_map<std::string, Variant> variants;		///< Requested variants by their definitions
+		unsigned long long frame;								///< Amount of Update() calls
+	};
+
+	ShaderVariants OGLU_API MakeShaderVariants(const ShaderFiles& files);
+}
+
+#endif
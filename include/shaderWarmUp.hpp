@@ -0,0 +1,50 @@
+/*****************************************************************//**
+ * \file   shaderWarmUp.hpp
+ * \brief  Off-screen draws that make drivers finish shader code generation
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef SHADERWARMUP_HPP
+#define SHADERWARMUP_HPP
+
+#include <core.hpp>
+#include <shader.hpp>
+#include <vertexArray.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	/**
+	 * @brief A combination of program, vertex layout and state that will be drawn with.
+	 */
+	struct OGLU_API ShaderWarmUp
+	{
+		/*@{*/
+		Shader shader;				///< Program to warm up
+		VertexArray vertexArray;	///< VAO providing the vertex layout the program is drawn with
+		bool depthTest;				///< Draw with GL_DEPTH_TEST enabled
+		bool blend;					///< Draw with GL_BLEND enabled, using the current blend function
+		bool cullFace;				///< Draw with GL_CULL_FACE enabled
+		/*@}*/
+	};
+
+	/**
+	 * @brief Draw every combination once, so the first real frame doesn't stall.
+	 *
+	 * Many drivers only generate the final code of a program once it is drawn with a
+	 * specific vertex layout and state. This issues a draw of a single triangle per
+	 * combination into a 1x1 framebuffer and waits for it to finish, so that work happens
+	 * at load time instead. The framebuffer binding, viewport and the toggled state are
+	 * restored afterwards.
+	 *
+	 * @param[in] combinations Array of combinations
+	 * @param[in] combinationsSize Size of the combinations array
+	 *
+	 * @return The time each warm-up draw took in milliseconds, in the same order as @p combinations.
+	 */
+	std::vector<double> OGLU_API WarmUpShaders(const ShaderWarmUp* combinations, size_t combinationsSize);
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*****************************************************************//**
+ * \file   stateTracker.hpp
+ * \brief  Avoids redundant OpenGL binding calls
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef STATETRACKER_HPP
+#define STATETRACKER_HPP
+
+#include <core.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	/**
+	 * @brief Counters of binding calls that went through a StateTracker.
+	 *
+	 * Reset these counters every frame to get per-frame numbers.
+	 */
+	struct OGLU_API StateTrackerStats
+	{
+		/*@{*/
+		unsigned long long issued;	///< Calls forwarded to OpenGL
+		unsigned long long elided;	///< Calls dropped because they wouldn't have changed anything
+		/*@}*/
+	};
+
+	/**
+	 * @brief Remembers the bindings of an OpenGL context.
+	 *
+	 * Every program, pipeline, VAO and texture binding done by OGLU goes through the tracker
+	 * of the current context, which drops calls that would bind what is already bound.
+	 * Applications with a single context can use the default tracker returned by
+	 * Current(), applications with more contexts should keep one tracker per context
+	 * and make it current together with the context.
+	 *
+	 * If OpenGL state is changed without OGLU, call Invalidate() afterwards.
+	 */
+	class OGLU_API StateTracker
+	{
+	public:
+		StateTracker();
+
+		/**
+		 * @brief Get the tracker of the current context.
+		 */
+		static StateTracker& Current();
+
+		/**
+		 * @brief Set the tracker of the current context.
+		 *
+		 * @param[in] tracker The tracker to use, or nullptr to use the default tracker
+		 */
+		static void MakeCurrent(StateTracker* tracker);
+
+		/**
+		 * @brief Forget all bindings, the next binding of every kind is forwarded to OpenGL.
+		 */
+		void Invalidate();
+
+		/**
+		 * @brief Wrapper for glUseProgram.
+		 *
+		 * @param[in] program Handle to the program
+		 */
+		void UseProgram(GLuint program);
+
+		/**
+		 * @brief Wrapper for glBindProgramPipeline.
+		 *
+		 * The pipeline is only used while no program is in use.
+		 *
+		 * @param[in] pipeline Handle to the program pipeline
+		 */
+		void BindProgramPipeline(GLuint pipeline);
+
+		/**
+		 * @brief Wrapper for glBindVertexArray.
+		 *
+		 * @param[in] vertexArray Handle to the VAO
+		 */
+		void BindVertexArray(GLuint vertexArray);
+
+		/**
+		 * @brief Wrapper for glActiveTexture.
+		 *
+		 * @param[in] unit Index of the texture unit (an offset to @p GL_TEXTURE0)
+		 */
+		void ActiveTexture(GLuint unit);
+
+		/**
+		 * @brief Wrapper for glBindTexture on the active texture unit.
+		 *
+		 * Only GL_TEXTURE_2D bindings are tracked, other targets are always forwarded.
+		 *
+		 * @param[in] target Texture target
+		 * @param[in] texture Handle to the texture
+		 */
+		void BindTexture(GLenum target, GLuint texture);
+
+		/**
+		 * @brief Makes a texture unit active and binds a texture to it.
+		 *
+		 * @param[in] unit Index of the texture unit
+		 * @param[in] target Texture target
+		 * @param[in] texture Handle to the texture
+		 */
+		void BindTexture(GLuint unit, GLenum target, GLuint texture);
+
+		/**
+		 * @brief Must be called before a program is deleted, so a new program with the same handle isn't mistaken for it.
+		 */
+		void OnDeleteProgram(GLuint program);
+
+		/**
+		 * @brief Must be called before a program pipeline is deleted, OpenGL unbinds deleted pipelines.
+		 */
+		void OnDeleteProgramPipeline(GLuint pipeline);
+
+		/**
+		 * @brief Must be called before a VAO is deleted, OpenGL unbinds deleted VAOs.
+		 */
+		void OnDeleteVertexArray(GLuint vertexArray);
+
+		/**
+		 * @brief Must be called before a texture is deleted, OpenGL unbinds deleted textures.
+		 */
+		void OnDeleteTexture(GLuint texture);
+
+		/**
+		 * @brief Control wether AbstractVertexArray::BindAndDraw() unbinds the VAO after drawing.
+		 *
+		 * Unbinding is the default. Without it consecutive draws of the same VAO don't rebind it.
+		 *
+		 * @param[in] unbind True to unbind after every draw
+		 */
+		void SetUnbindAfterDraw(bool unbind);
+
+		/**
+		 * @brief Check wether AbstractVertexArray::BindAndDraw() unbinds the VAO after drawing.
+		 */
+		bool GetUnbindAfterDraw() const;
+
+		/**
+		 * @brief Get the counters of issued and elided calls.
+		 *
+		 * @return The counters accumulated since creation or the last reset.
+		 */
+		const StateTrackerStats& GetStats() const;
+
+		/**
+		 * @brief Reset the counters of issued and elided calls to zero.
+		 */
+		void ResetStats();
+
+	private:
+		/**
+		 * @brief Counts a call and checks wether it changes anything.
+		 *
+		 * @return True if the call has to be forwarded to OpenGL.
+		 */
+		inline bool Changes(GLuint& current, GLuint value);
+
+	private:
+		GLuint program;					///< Program in use
+		GLuint pipeline;				///< Bound program pipeline
+		GLuint vertexArray;				///< Bound VAO
+		GLuint activeUnit;				///< Active texture unit
+		std::vector<GLuint> textures;	///< GL_TEXTURE_2D binding of each texture unit
+		bool unbindAfterDraw;			///< Wether BindAndDraw() unbinds the VAO
+		StateTrackerStats stats;		///< Issued and elided calls
+	};
+}
+
+#endif
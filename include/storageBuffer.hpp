@@ -0,0 +1,179 @@
+/*****************************************************************//**
+ * \file   storageBuffer.hpp
+ * \brief  Shader storage buffer objects
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef STORAGEBUFFER_HPP
+#define STORAGEBUFFER_HPP
+
+#include <core.hpp>
+#include <uniformBuffer.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	class AbstractStorageBuffer;
+
+	typedef std::shared_ptr<AbstractStorageBuffer> StorageBuffer;
+
+	/**
+	 * @brief An object representing an OpenGL Shader Storage Buffer.
+	 *
+	 * Storage buffers back `buffer` blocks, which can be far larger than uniform
+	 * blocks and may end in an unsized array. This makes them suitable for thousands
+	 * of lights or model matrices that are uploaded once per frame. Once bound to a
+	 * binding point the buffer can be read (and written) by every program that binds
+	 * one of its storage blocks to the same point. Also see: AbstractShader::BindStorageBlock()
+	 *
+	 * Storage buffers require OpenGL 4.3.
+	 *
+	 * This class cannot be instantiated, this should be done via MakeStorageBuffer().
+	 */
+	class OGLU_API AbstractStorageBuffer
+	{
+	public:
+		/**
+		 * @brief Constructs a new storage buffer.
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] usage Usage hint of the buffer
+		 *
+		 * @throws std::runtime_error If the context doesn't support storage buffers
+		 *
+		 * @return A shared pointer to the storage buffer.
+		 */
+		friend StorageBuffer OGLU_API MakeStorageBuffer(GLsizeiptr size, GLenum usage);
+
+		/**
+		 * @brief Copy constructor.
+		 *
+		 * Copying a buffer is generally possible. Since the user is given a shared pointer the
+		 * buffer is only deleted once every instance has been deconstructed.
+		 *
+		 * @param[in] other Buffer to copy from
+		 */
+		AbstractStorageBuffer(const AbstractStorageBuffer& other);
+		~AbstractStorageBuffer();
+
+		/**
+		 * @brief Bind this buffer to GL_SHADER_STORAGE_BUFFER.
+		 */
+		void Bind();
+
+		/**
+		 * @brief Unbind GL_SHADER_STORAGE_BUFFER.
+		 */
+		void Unbind();
+
+		/**
+		 * @brief Bind the entire buffer to an indexed binding point.
+		 *
+		 * @param[in] index The binding point
+		 */
+		void BindBase(GLuint index);
+
+		/**
+		 * @brief Bind a range of the buffer to an indexed binding point.
+		 *
+		 * @param[in] index The binding point
+		 * @param[in] offset Offset of the range, must be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+		 * @param[in] size Size of the range
+		 */
+		void BindRange(GLuint index, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Change the size of the buffer.
+		 *
+		 * The handle stays the same, so existing bindings don't have to be redone.
+		 * Ranges bound with BindRange() have to be bound again if they no longer fit.
+		 *
+		 * @param[in] size New size of the buffer in bytes
+		 * @param[in] preserve True to keep the contents that fit into the new size
+		 */
+		void Resize(GLsizeiptr size, bool preserve = true);
+
+		/**
+		 * @brief Update a part of the buffer.
+		 *
+		 * @param[in] data Data to copy into the buffer
+		 * @param[in] offset Offset into the buffer
+		 * @param[in] size Size of @p data in bytes, the range must fit into the buffer
+		 */
+		void SetData(const void* data, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Copy a block into the buffer.
+		 *
+		 * @param[in] block The block to upload
+		 * @param[in] offset Offset into the buffer
+		 */
+		template<typename Layout, typename... Members>
+		void SetData(const UniformBlock<Layout, Members...>& block, GLintptr offset = 0)
+		{
+			SetData(block.Data(), offset, UniformBlock<Layout, Members...>::Size);
+		}
+
+		/**
+		 * @brief Replace the contents of the buffer.
+		 *
+		 * This is meant for data that is rewritten every frame. The old storage is
+		 * orphaned instead of overwritten, so the upload never waits for draws that
+		 * still read the previous contents. The buffer grows if @p size doesn't fit.
+		 *
+		 * @param[in] data Data to copy into the buffer
+		 * @param[in] size Size of @p data in bytes
+		 */
+		void Upload(const void* data, GLsizeiptr size);
+
+		/**
+		 * @brief Replace the contents of the buffer with an array.
+		 *
+		 * The elements are copied as they are, so their layout has to match the std430
+		 * layout of the array in the shader (e.g. use glm::vec4 instead of glm::vec3).
+		 *
+		 * @param[in] elements Elements to copy into the buffer
+		 */
+		template<typename T>
+		void Upload(const std::vector<T>& elements)
+		{
+			Upload(elements.data(), elements.size() * sizeof(T));
+		}
+
+		/**
+		 * @brief Get the size of the buffer.
+		 *
+		 * @return Size of the buffer in bytes.
+		 */
+		GLsizeiptr GetSize() const;
+
+		/**
+		 * @brief Get the handle of the buffer, e.g. to use it as the source of indirect commands.
+		 */
+		GLuint GetHandle() const;
+
+	private:
+		/**
+		 * @brief Construct a storage buffer.
+		 *
+		 * To avoid accidental deletion of buffers while they're still in use,
+		 * this constructor has been made private. To create a buffer use
+		 * MakeStorageBuffer().
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] usage Usage hint of the buffer
+		 */
+		AbstractStorageBuffer(GLsizeiptr size, GLenum usage);
+
+	private:
+		GLuint buffer;		///< Handle to the OpenGL buffer
+		GLsizeiptr size;	///< Size of the buffer in bytes
+		GLenum usage;		///< Usage hint the storage is (re)allocated with
+	};
+
+	StorageBuffer OGLU_API MakeStorageBuffer(GLsizeiptr size, GLenum usage = GL_DYNAMIC_DRAW);
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*****************************************************************//**
+ * \file   streamBuffer.hpp
+ * \brief  Persistently mapped ring buffer for data that changes every frame
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef STREAMBUFFER_HPP
+#define STREAMBUFFER_HPP
+
+#include <core.hpp>
+#include <buffer.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	class AbstractStreamBuffer;
+
+	typedef std::shared_ptr<AbstractStreamBuffer> StreamBuffer;
+
+	/**
+	 * @brief A persistently mapped buffer split into one region per frame in flight.
+	 *
+	 * The buffer is mapped once with GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, so
+	 * per-frame vertices, instance data or uniforms are written straight into GPU visible
+	 * memory without any copies by the driver. Every frame writes into the next region,
+	 * and a fence is placed behind the draws of a frame. A region is only reused once
+	 * its fence has signaled, so the CPU only waits if the GPU falls more than the
+	 * amount of regions behind.
+	 *
+	 *		stream->BeginFrame();
+	 *		GLintptr offset;
+	 *		Vertex* vertices = static_cast<Vertex*>(stream->Allocate(count * sizeof(Vertex), offset, sizeof(Vertex)));
+	 *		// ... write the vertices ...
+	 *		vao->SetRange((GLint)(offset / sizeof(Vertex)), 0, count);
+	 *		vao->BindAndDraw();
+	 *		stream->EndFrame();
+	 *
+	 * Here vao was created with MakeVertexArray() from GetBuffer(). Stream buffers require OpenGL 4.4.
+	 *
+	 * This class cannot be instantiated, this should be done via MakeStreamBuffer().
+	 */
+	class OGLU_API AbstractStreamBuffer
+	{
+	public:
+		/**
+		 * @brief Constructs a new stream buffer.
+		 *
+		 * @param[in] frameSize Size of the region of a single frame in bytes
+		 * @param[in] frameCount Amount of regions, i.e. how many frames the GPU may lag behind
+		 *
+		 * @throws std::runtime_error If the context doesn't support persistent mapping
+		 *
+		 * @return A shared pointer to the stream buffer.
+		 */
+		friend StreamBuffer OGLU_API MakeStreamBuffer(GLsizeiptr frameSize, unsigned int frameCount);
+
+		AbstractStreamBuffer(const AbstractStreamBuffer& other) = delete;
+		~AbstractStreamBuffer();
+
+		/**
+		 * @brief Start writing the next frame.
+		 *
+		 * Moves on to the next region, waiting for the GPU if it still reads from it.
+		 *
+		 * @throws std::runtime_error If waiting for the fence fails
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief Finish the current frame.
+		 *
+		 * Call this after all draws reading the data of the frame were issued, it
+		 * fences the region.
+		 */
+		void EndFrame();
+
+		/**
+		 * @brief Reserve memory inside the region of the current frame.
+		 *
+		 * The memory can be written until EndFrame() is called, it doesn't have to be flushed.
+		 *
+		 * @param[in] size Size of the memory in bytes
+		 * @param[out] offset Receives the offset of the memory from the start of the buffer
+		 * @param[in] alignment The offset is a multiple of this, e.g. the size of a vertex or GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+		 *
+		 * @throws std::runtime_error If no frame was begun or the region of the frame is full
+		 *
+		 * @return Pointer to write the data to.
+		 */
+		void* Allocate(GLsizeiptr size, GLintptr& offset, GLsizeiptr alignment = 4);
+
+		/**
+		 * @brief Bind a range of the buffer to an indexed binding point.
+		 *
+		 * @param[in] target The target, e.g. GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+		 * @param[in] index The binding point
+		 * @param[in] offset Offset of the range, as returned by Allocate()
+		 * @param[in] size Size of the range
+		 */
+		void BindRange(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Get the underlying buffer, e.g. to create a VAO reading from it.
+		 */
+		const Buffer& GetBuffer() const;
+
+		/**
+		 * @brief Get the size of the region of a single frame.
+		 */
+		GLsizeiptr GetFrameSize() const;
+
+		/**
+		 * @brief Get the amount of times BeginFrame() had to wait for the GPU.
+		 */
+		size_t GetStallCount() const;
+
+	private:
+		/**
+		 * @brief Construct a stream buffer.
+		 *
+		 * To avoid accidental deletion of buffers while they're still in use,
+		 * this constructor has been made private. To create a buffer use
+		 * MakeStreamBuffer().
+		 *
+		 * @param[in] frameSize Size of the region of a single frame in bytes
+		 * @param[in] frameCount Amount of regions
+		 */
+		AbstractStreamBuffer(GLsizeiptr frameSize, unsigned int frameCount);
+
+	private:
+		Buffer buffer;				///< Buffer with the storage of all regions
+		unsigned char* mapping;		///< Persistent mapping of the whole buffer
+		GLsizeiptr frameSize;		///< Size of a region in bytes
+		std::vector<GLsync> fences;	///< Fence of every region, nullptr if it isn't in use by the GPU
+		unsigned int frame;			///< Index of the current region
+		GLsizeiptr frameOffset;		///< Amount of bytes of the current region that were handed out
+		bool inFrame;				///< Wether BeginFrame() was called without EndFrame()
+		size_t stalls;				///< Amount of times BeginFrame() had to wait
+	};
+
+	StreamBuffer OGLU_API MakeStreamBuffer(GLsizeiptr frameSize, unsigned int frameCount = 3);
+}
+
+#endif
@@ -0,0 +1,433 @@
+/*****************************************************************//**
+ * \file   uniformBuffer.hpp
+ * \brief  Uniform buffer objects and compile time block layouts
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef UNIFORMBUFFER_HPP
+#define UNIFORMBUFFER_HPP
+
+#include <core.hpp>
+
+#include <array>
+#include <tuple>
+#include <cstring>
+#include <glm/glm.hpp>
+
+namespace oglu
+{
+	/**
+	 * @brief Rounds @p value up to the next multiple of @p alignment.
+	 */
+	constexpr size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	/**
+	 * @brief Tag for blocks declared with layout(std140).
+	 *
+	 * Arrays and structs are aligned to at least 16 bytes.
+	 */
+	struct Std140
+	{
+		static constexpr size_t AggregateAlignment(size_t alignment) { return alignment < 16 ? 16 : alignment; }
+	};
+
+	/**
+	 * @brief Tag for blocks declared with layout(std430).
+	 *
+	 * Arrays and structs are aligned like their members.
+	 */
+	struct Std430
+	{
+		static constexpr size_t AggregateAlignment(size_t alignment) { return alignment; }
+	};
+
+	/**
+	 * @brief Marks an array member of a UniformBlock.
+	 *
+	 * @tparam T Type of the elements
+	 * @tparam N Amount of elements
+	 */
+	template<typename T, size_t N>
+	struct UniformArray {};
+
+	template<typename Layout, typename... Members>
+	class UniformBlock;
+
+	/**
+	 * @brief Alignment, size and serialization of a block member.
+	 *
+	 * Specializations exist for 32 bit scalars, glm vectors and matrices,
+	 * UniformArray and nested UniformBlock types. Using any other type is a
+	 * compile time error.
+	 *
+	 * @tparam Layout Std140 or Std430
+	 * @tparam T Type of the member
+	 */
+	template<typename Layout, typename T>
+	struct BlockMemberTraits;
+
+	/**
+	 * @brief Traits of 32 bit scalars.
+	 */
+	template<typename T>
+	struct ScalarMemberTraits
+	{
+		typedef T Value;
+		static constexpr size_t Alignment = 4;
+		static constexpr size_t Size = 4;
+
+		static void Write(unsigned char* dst, const Value& value) { memcpy(dst, &value, Size); }
+	};
+
+	template<typename Layout> struct BlockMemberTraits<Layout, GLfloat> : ScalarMemberTraits<GLfloat> {};
+	template<typename Layout> struct BlockMemberTraits<Layout, GLint> : ScalarMemberTraits<GLint> {};
+	template<typename Layout> struct BlockMemberTraits<Layout, GLuint> : ScalarMemberTraits<GLuint> {};
+
+	/**
+	 * @brief Traits of bools, which are 32 bit wide in GLSL.
+	 */
+	template<typename Layout>
+	struct BlockMemberTraits<Layout, bool>
+	{
+		typedef bool Value;
+		static constexpr size_t Alignment = 4;
+		static constexpr size_t Size = 4;
+
+		static void Write(unsigned char* dst, const Value& value)
+		{
+			GLuint v = value ? 1 : 0;
+			memcpy(dst, &v, Size);
+		}
+	};
+
+	/**
+	 * @brief Traits of vectors, vec3 is aligned like a vec4.
+	 */
+	template<typename Layout, glm::length_t L, typename T, glm::qualifier Q>
+	struct BlockMemberTraits<Layout, glm::vec<L, T, Q>>
+	{
+		static_assert(sizeof(T) == 4, "Only vectors of 32 bit components can be used in blocks");
+
+		typedef glm::vec<L, T, Q> Value;
+		static constexpr size_t Alignment = (L == 2) ? 8 : 16;
+		static constexpr size_t Size = L * 4;
+
+		static void Write(unsigned char* dst, const Value& value) { memcpy(dst, &value[0], Size); }
+	};
+
+	/**
+	 * @brief Traits of arrays, the stride of an element is a multiple of the array alignment.
+	 */
+	template<typename Layout, typename T, size_t N>
+	struct BlockMemberTraits<Layout, UniformArray<T, N>>
+	{
+		typedef BlockMemberTraits<Layout, T> Element;
+		typedef std::array<typename Element::Value, N> Value;
+		static constexpr size_t Alignment = Layout::AggregateAlignment(Element::Alignment);
+		static constexpr size_t Stride = AlignUp(Element::Size, Alignment);
+		static constexpr size_t Size = Stride * N;
+
+		static void Write(unsigned char* dst, const Value& value)
+		{
+			for (size_t i = 0; i < N; i++)
+				Element::Write(dst + i * Stride, value[i]);
+		}
+
+		static void WriteElement(unsigned char* dst, size_t index, const typename Element::Value& value)
+		{
+			Element::Write(dst + index * Stride, value);
+		}
+	};
+
+	/**
+	 * @brief Traits of matrices, which are laid out like an array of column vectors.
+	 */
+	template<typename Layout, glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+	struct BlockMemberTraits<Layout, glm::mat<C, R, T, Q>>
+	{
+		typedef BlockMemberTraits<Layout, UniformArray<glm::vec<R, T, Q>, C>> Columns;
+		typedef glm::mat<C, R, T, Q> Value;
+		static constexpr size_t Alignment = Columns::Alignment;
+		static constexpr size_t Size = Columns::Size;
+
+		static void Write(unsigned char* dst, const Value& value)
+		{
+			for (glm::length_t c = 0; c < C; c++)
+				Columns::WriteElement(dst, c, value[c]);
+		}
+	};
+
+	/**
+	 * @brief Traits of nested blocks, i.e. GLSL structs.
+	 */
+	template<typename Layout, typename... Members>
+	struct BlockMemberTraits<Layout, UniformBlock<Layout, Members...>>
+	{
+		typedef UniformBlock<Layout, Members...> Value;
+		static constexpr size_t Alignment = Value::Alignment;
+		static constexpr size_t Size = Value::Size;
+
+		static void Write(unsigned char* dst, const Value& value) { memcpy(dst, value.Data(), Size); }
+	};
+
+	/**
+	 * @brief Computes the byte offsets of the members of a block.
+	 */
+	template<typename Layout, typename... Members>
+	constexpr std::array<size_t, sizeof...(Members)> ComputeBlockOffsets()
+	{
+		constexpr size_t alignments[] = { BlockMemberTraits<Layout, Members>::Alignment... };
+		constexpr size_t sizes[] = { BlockMemberTraits<Layout, Members>::Size... };
+
+		std::array<size_t, sizeof...(Members)> offsets = {};
+		size_t offset = 0;
+		for (size_t i = 0; i < sizeof...(Members); i++)
+		{
+			offset = AlignUp(offset, alignments[i]);
+			offsets[i] = offset;
+			offset += sizes[i];
+		}
+
+		return offsets;
+	}
+
+	/**
+	 * @brief Computes the alignment of a block when it is used as a struct.
+	 */
+	template<typename Layout, typename... Members>
+	constexpr size_t ComputeBlockAlignment()
+	{
+		constexpr size_t alignments[] = { BlockMemberTraits<Layout, Members>::Alignment... };
+
+		size_t alignment = 0;
+		for (size_t a : alignments)
+			alignment = (a > alignment) ? a : alignment;
+
+		return Layout::AggregateAlignment(alignment);
+	}
+
+	/**
+	 * @brief Computes the size of a block, including the padding at its end.
+	 */
+	template<typename Layout, typename... Members>
+	constexpr size_t ComputeBlockSize()
+	{
+		constexpr size_t sizes[] = { BlockMemberTraits<Layout, Members>::Size... };
+		constexpr std::array<size_t, sizeof...(Members)> offsets = ComputeBlockOffsets<Layout, Members...>();
+
+		return AlignUp(offsets[sizeof...(Members) - 1] + sizes[sizeof...(Members) - 1], ComputeBlockAlignment<Layout, Members...>());
+	}
+
+	/**
+	 * @brief CPU side image of a uniform or storage block.
+	 *
+	 * The offsets of all members are computed at compile time from the layout rules,
+	 * so the block can be copied into a buffer as is. Members are addressed by their
+	 * index in the template parameter list:
+	 *
+	 *     // layout(std140) uniform Camera { mat4 view; mat4 projection; vec3 viewPos; };
+	 *     typedef oglu::UniformBlock<oglu::Std140, glm::mat4, glm::mat4, glm::vec3> CameraBlock;
+	 *     static_assert(CameraBlock::Offset<2> == 128, "Unexpected layout");
+	 *
+	 *     CameraBlock camera;
+	 *     camera.Set<2>(position);
+	 *
+	 * A UniformBlock can itself be the member of another block with the same layout,
+	 * this corresponds to a struct member in GLSL.
+	 *
+	 * @tparam Layout Std140 or Std430
+	 * @tparam Members Types of the members, in declaration order
+	 */
+	template<typename Layout, typename... Members>
+	class UniformBlock
+	{
+		static_assert(sizeof...(Members) > 0, "A block needs at least one member");
+
+	public:
+		/**
+		 * @brief Traits of the member at index @p I.
+		 */
+		template<size_t I> using Member = BlockMemberTraits<Layout, std::tuple_element_t<I, std::tuple<Members...>>>;
+
+		static constexpr std::array<size_t, sizeof...(Members)> Offsets = ComputeBlockOffsets<Layout, Members...>();	///< Byte offsets of all members
+		template<size_t I> static constexpr size_t Offset = Offsets[I];								///< Byte offset of the member at index @p I
+		static constexpr size_t Alignment = ComputeBlockAlignment<Layout, Members...>();					///< Alignment of the block when used as a struct
+		static constexpr size_t Size = ComputeBlockSize<Layout, Members...>();								///< Size of the block in bytes
+
+		/**
+		 * @brief Set a member.
+		 *
+		 * @tparam I Index of the member
+		 * @param[in] value The new value of the member
+		 */
+		template<size_t I> void Set(const typename Member<I>::Value& value)
+		{
+			Member<I>::Write(data + Offset<I>, value);
+		}
+
+		/**
+		 * @brief Set a single element of an array member.
+		 *
+		 * @tparam I Index of the member, which must be a UniformArray
+		 * @param[in] index Index of the array element
+		 * @param[in] value The new value of the element
+		 */
+		template<size_t I> void SetElement(size_t index, const typename Member<I>::Element::Value& value)
+		{
+			Member<I>::WriteElement(data + Offset<I>, index, value);
+		}
+
+		/**
+		 * @brief Get the serialized block.
+		 *
+		 * @return A pointer to Size bytes.
+		 */
+		const unsigned char* Data() const
+		{
+			return data;
+		}
+
+	private:
+		alignas(16) unsigned char data[Size] = {};	///< Serialized members
+	};
+
+	// Layouts from the examples in the OpenGL specification
+	static_assert(UniformBlock<Std140, GLfloat, glm::vec3>::Offset<1> == 16, "std140 vec3 must be aligned to 16 bytes");
+	static_assert(UniformBlock<Std140, glm::vec3, GLfloat>::Offset<1> == 12, "std140 scalars may follow a vec3 directly");
+	static_assert(UniformBlock<Std140, UniformArray<GLfloat, 2>>::Size == 32, "std140 array strides are rounded up to 16 bytes");
+	static_assert(UniformBlock<Std430, UniformArray<GLfloat, 2>>::Size == 8, "std430 arrays of scalars are tightly packed");
+	static_assert(UniformBlock<Std140, glm::mat3>::Size == 48, "std140 mat3 columns are padded to vec4");
+	static_assert(UniformBlock<Std430, glm::mat2>::Size == 16, "std430 mat2 columns are not padded");
+	static_assert(UniformBlock<Std140, GLfloat, UniformBlock<Std140, GLfloat>, GLfloat>::Offset<2> == 32, "std140 structs are padded to 16 bytes");
+
+	class AbstractUniformBuffer;
+
+	typedef std::shared_ptr<AbstractUniformBuffer> UniformBuffer;
+
+	/**
+	 * @brief An object representing an OpenGL Uniform Buffer.
+	 *
+	 * A uniform buffer holds the data of one or more uniform blocks. Once bound to
+	 * a binding point it can be shared by every program that binds one of its blocks
+	 * to the same point. Also see: AbstractShader::BindUniformBlock()
+	 *
+	 * This class cannot be instantiated, this should be done via MakeUniformBuffer().
+	 */
+	class OGLU_API AbstractUniformBuffer
+	{
+	public:
+		/**
+		 * @brief Constructs a new uniform buffer.
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] usage Usage hint of the buffer
+		 *
+		 * @return A shared pointer to the uniform buffer.
+		 */
+		friend UniformBuffer OGLU_API MakeUniformBuffer(GLsizeiptr size, GLenum usage);
+
+		/**
+		 * @brief Copy constructor.
+		 *
+		 * Copying a buffer is generally possible. Since the user is given a shared pointer the
+		 * buffer is only deleted once every instance has been deconstructed.
+		 *
+		 * @param[in] other Buffer to copy from
+		 */
+		AbstractUniformBuffer(const AbstractUniformBuffer& other);
+		~AbstractUniformBuffer();
+
+		/**
+		 * @brief Bind this buffer to GL_UNIFORM_BUFFER.
+		 */
+		void Bind();
+
+		/**
+		 * @brief Unbind GL_UNIFORM_BUFFER.
+		 */
+		void Unbind();
+
+		/**
+		 * @brief Bind the entire buffer to an indexed binding point.
+		 *
+		 * @param[in] index The binding point
+		 */
+		void BindBase(GLuint index);
+
+		/**
+		 * @brief Bind a range of the buffer to an indexed binding point.
+		 *
+		 * @param[in] index The binding point
+		 * @param[in] offset Offset of the range, must be a multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+		 * @param[in] size Size of the range
+		 */
+		void BindRange(GLuint index, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Update a part of the buffer.
+		 *
+		 * @param[in] data Data to copy into the buffer
+		 * @param[in] offset Offset into the buffer
+		 * @param[in] size Size of @p data in bytes
+		 */
+		void SetData(const void* data, GLintptr offset, GLsizeiptr size);
+
+		/**
+		 * @brief Copy a block into the buffer.
+		 *
+		 * @param[in] block The block to upload
+		 * @param[in] offset Offset into the buffer
+		 */
+		template<typename Layout, typename... Members>
+		void SetData(const UniformBlock<Layout, Members...>& block, GLintptr offset = 0)
+		{
+			SetData(block.Data(), offset, UniformBlock<Layout, Members...>::Size);
+		}
+
+		/**
+		 * @brief Get the size of the buffer.
+		 *
+		 * @return Size of the buffer in bytes.
+		 */
+		GLsizeiptr GetSize() const;
+
+	private:
+		/**
+		 * @brief Construct a uniform buffer.
+		 *
+		 * To avoid accidental deletion of buffers while they're still in use,
+		 * this constructor has been made private. To create a buffer use
+		 * MakeUniformBuffer().
+		 *
+		 * @param[in] size Size of the buffer in bytes
+		 * @param[in] usage Usage hint of the buffer
+		 */
+		AbstractUniformBuffer(GLsizeiptr size, GLenum usage);
+
+	private:
+		GLuint buffer;		///< Handle to the OpenGL buffer
+		GLsizeiptr size;	///< Size of the buffer in bytes
+	};
+
+	UniformBuffer OGLU_API MakeUniformBuffer(GLsizeiptr size, GLenum usage = GL_DYNAMIC_DRAW);
+
+	/**
+	 * @brief Constructs a new uniform buffer that fits a block.
+	 *
+	 * @tparam Block A UniformBlock type
+	 * @param[in] usage Usage hint of the buffer
+	 *
+	 * @return A shared pointer to the uniform buffer.
+	 */
+	template<typename Block>
+	UniformBuffer MakeUniformBuffer(GLenum usage = GL_DYNAMIC_DRAW)
+	{
+		return MakeUniformBuffer(Block::Size, usage);
+	}
+}
+
+#endif
@@ -10,6 +10,9 @@
 #define VERTEXARRAY_HPP
 
 #include <core.hpp>
+#include <buffer.hpp>
+
+#include <vector>
 
 namespace oglu
 {
@@ -58,15 +61,65 @@ namespace oglu
 		 */
 		friend VertexArray OGLU_API MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize, const VertexAttribute* topology, size_t topologySize);
 
+		/**
+		 * @brief Constructs a new VAO from indices of any size.
+		 *
+		 * The indices are stored as GL_UNSIGNED_SHORT if every index fits into 16 bits, and
+		 * as GL_UNSIGNED_INT otherwise, no matter what type they are passed in as. If the
+		 * type doesn't change, the indices are uploaded without being copied. 8 bit indices
+		 * are widened as well, since many GPUs don't support them natively.
+		 *
+		 * @param[in] vertices		Array of vertex data
+		 * @param[in] verticesSize	Size of vertex array
+		 * @param[in] indices		Array of index data
+		 * @param[in] indicesSize	Size of index array
+		 * @param[in] indexType		Type of the indices, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 * @param[in] topology		Array of VertexAttribute 
+		 * @param[in] topologySize	Size of topology array
+		 *
+		 * @throws std::runtime_error If @p indexType isn't one of the above
+		 *
+		 * @return A shared pointer to the VAO.
+		 */
+		friend VertexArray OGLU_API MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType, const VertexAttribute* topology, size_t topologySize);
+
 		/**
 		 * @brief Constructs a new VAO.
 		 * 
-		 * Reads an .obj file and converts it into a VAO
+		 * Reads an .obj file and converts it into a VAO. Also see: LoadObj()
+		 * 
+		 * If a mesh cache directory is set, the parsed model is stored there and later
+		 * calls upload the cached data instead. Also see: SetMeshCacheDirectory()
 		 * 
 		 * @param[in] filepath Path to the .obj file
+		 * 
+		 * @throws std::runtime_error If the file can't be read or is malformed
 		 */
 		friend VertexArray OGLU_API MakeVertexArray(const char* filepath);
 
+		/**
+		 * @brief Constructs a new VAO that draws a range of existing buffers.
+		 * 
+		 * This lets many VAOs share the same buffers, e.g. when several meshes were packed
+		 * into one vertex and one index buffer. The indices of the range are relative to
+		 * @p baseVertex. Also see: AbstractMeshPool, which manages the ranges and shares
+		 * a single VAO between its meshes as well.
+		 * 
+		 * @param[in] vertexBuffer	Buffer containing the vertex data
+		 * @param[in] indexBuffer	Buffer containing the indices, or nullptr to draw the vertices in order
+		 * @param[in] topology		Array of VertexAttribute 
+		 * @param[in] topologySize	Size of topology array
+		 * @param[in] baseVertex	Index of the first vertex of the range
+		 * @param[in] firstIndex	Index of the first index of the range, ignored without @p indexBuffer
+		 * @param[in] count			Amount of indices (or vertices without @p indexBuffer) of the range
+		 * @param[in] indexType		Type of the indices, GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 * 
+		 * @throws std::runtime_error If @p indexType isn't one of the above
+		 * 
+		 * @return A shared pointer to the VAO.
+		 */
+		friend VertexArray OGLU_API MakeVertexArray(const Buffer& vertexBuffer, const Buffer& indexBuffer, const VertexAttribute* topology, size_t topologySize, GLint baseVertex, GLsizei firstIndex, GLsizei count, GLenum indexType);
+
 		/**
 		 * @brief Copy constructor.
 		 *
@@ -99,9 +152,42 @@ namespace oglu
 		 * @brief Draw this VAO.
 		 * 
 		 * This function binds, draws, then unbinds the VAO. Also see: Draw()
+		 * 
+		 * The VAO stays bound if StateTracker::SetUnbindAfterDraw() was disabled, then
+		 * drawing the same VAO again doesn't rebind it.
 		 */
 		void BindAndDraw();
 
+		/**
+		 * @brief Draw the beginning of this VAO.
+		 * 
+		 * Works like BindAndDraw(), but only draws the first @p count indices
+		 * (or vertices, if the VAO has no indices).
+		 * 
+		 * @param[in] count Amount of indices to draw, clamped to the size of the VAO
+		 */
+		void BindAndDraw(GLsizei count);
+
+		/**
+		 * @brief Change the range this VAO draws.
+		 *
+		 * This lets one VAO draw whatever was written to a streamed buffer this frame,
+		 * e.g. a range handed out by AbstractStreamBuffer::Allocate(). For VAOs of a mesh
+		 * pool this only changes what is drawn, the pool still frees the original range.
+		 *
+		 * @param[in] baseVertex	Index of the first vertex of the range
+		 * @param[in] firstIndex	Index of the first index of the range, ignored without indices
+		 * @param[in] count			Amount of indices (or vertices without indices) of the range
+		 */
+		void SetRange(GLint baseVertex, GLsizei firstIndex, GLsizei count);
+
+		/**
+		 * @brief Get the type of the indices.
+		 *
+		 * @return The type the indices are drawn with, or GL_NONE if the VAO has no indices.
+		 */
+		GLenum GetIndexType() const;
+
 	private:
 		/**
 		 * @brief Construct a VAO.
@@ -114,26 +200,94 @@ namespace oglu
 		 * @param[in] verticesSize	Size of vertex array
 		 * @param[in] indices		Array of index data
 		 * @param[in] indicesSize	Size of index array
+		 * @param[in] indexType		Type of the indices
 		 * @param[in] topology		Array of VertexAttribute 
 		 * @param[in] topologySize	Size of topology array
 		 */
-		AbstractVertexArray(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize, const VertexAttribute* topology, size_t topologySize);
+		AbstractVertexArray(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType, const VertexAttribute* topology, size_t topologySize);
+
+		/**
+		 * @brief Construct a VAO drawing a range of existing buffers.
+		 *
+		 * @param[in] VAO			VAO with the buffers and the topology set up
+		 * @param[in] vertexBuffer	Buffer containing the vertex data
+		 * @param[in] indexBuffer	Buffer containing the indices, may be nullptr
+		 * @param[in] baseVertex	Index of the first vertex of the range
+		 * @param[in] firstIndex	Index of the first index of the range
+		 * @param[in] count			Amount of indices (or vertices) of the range
+		 * @param[in] indexType		Type of the indices
+		 * @param[in] sharedStorage	If set, the VAO handle isn't owned, instead this is released with the last copy
+		 */
+		AbstractVertexArray(GLuint VAO, const Buffer& vertexBuffer, const Buffer& indexBuffer, GLint baseVertex, GLsizei firstIndex, GLsizei count, GLenum indexType, const std::shared_ptr<void>& sharedStorage);
+
+		/**
+		 * @brief Creates a VAO reading from the given buffers.
+		 *
+		 * @return The handle of the VAO.
+		 */
+		static GLuint SetupVertexArray(const Buffer& vertexBuffer, const Buffer& indexBuffer, const VertexAttribute* topology, size_t topologySize);
 
 		/**
 		 * @brief Registers and enables a Vertex Attribute Pointer.
 		 */
-		inline void RegisterVertexAttribPointer(GLuint index, const VertexAttribute& topology);
+		static inline void RegisterVertexAttribPointer(GLuint index, const VertexAttribute& topology);
 
-		// TODO: Create new class for Buffer objects. Then multiple VAOs can use the same buffers
-		GLuint VAO;		///< Handle to OpenGL VAO
-		GLuint VBO;		///< Handle to OpenGL VBO
-		GLuint EBO;		///< Handle to OpenGL EBO
-		GLsizei count;	///< Amount of indices
+		/**
+		 * @brief Get the size of an index type in bytes.
+		 *
+		 * @throws std::runtime_error If @p indexType isn't GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 */
+		static size_t GetIndexSize(GLenum indexType);
+
+		/**
+		 * @brief Get the largest index of an array.
+		 */
+		static GLuint GetMaxIndex(const GLvoid* indices, size_t count, GLenum indexType);
+
+		/**
+		 * @brief Converts indices to another type.
+		 *
+		 * @param[in] indices		Array of index data
+		 * @param[in] count			Amount of indices
+		 * @param[in] indexType		Type of the indices
+		 * @param[in] targetType	Type to convert to, every index has to fit into it
+		 * @param[out] storage		Holds the converted indices
+		 *
+		 * @return @p indices if the types are the same, otherwise the data of @p storage.
+		 */
+		static const GLvoid* ConvertIndices(const GLvoid* indices, size_t count, GLenum indexType, GLenum targetType, std::vector<unsigned char>& storage);
+
+		/**
+		 * @brief Issues the draw call for the first @p count indices (or vertices) of the range.
+		 */
+		void DrawRange(GLsizei count);
+
+		friend class AbstractMeshPool;
+
+		GLuint VAO;								///< Handle to OpenGL VAO
+		Buffer vertexBuffer;					///< Buffer containing the vertex data
+		Buffer indexBuffer;						///< Buffer containing the indices, nullptr if the VAO has none
+		std::shared_ptr<void> sharedStorage;	///< Set if the VAO handle belongs to a mesh pool, gives the range back to it when released
+		GLint baseVertex;						///< Index of the first vertex
+		GLsizei firstIndex;						///< Index of the first index
+		GLsizei count;							///< Amount of indices
+		GLenum indexType;						///< Type of the indices, GL_NONE if the VAO has none
 		bool useIndices;
 	};
 
+	/**
+	 * @brief Get the size of a vertex attribute in bytes.
+	 *
+	 * @param[in] attribute The attribute
+	 *
+	 * @return The size, or 0 if the type of the attribute is unknown.
+	 */
+	size_t OGLU_API GetVertexAttributeSize(const VertexAttribute& attribute);
+
 	VertexArray OGLU_API MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize, const VertexAttribute* topology, size_t topologySize);
+	VertexArray OGLU_API MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType, const VertexAttribute* topology, size_t topologySize);
 	VertexArray OGLU_API MakeVertexArray(const char* filepath);
+	VertexArray OGLU_API MakeVertexArray(const Buffer& vertexBuffer, const Buffer& indexBuffer, const VertexAttribute* topology, size_t topologySize, GLint baseVertex, GLsizei firstIndex, GLsizei count, GLenum indexType = GL_UNSIGNED_INT);
 }
 
 #endif
@@ -0,0 +1,170 @@
+/*****************************************************************//**
+ * \file   vertexCompression.hpp
+ * \brief  Quantization of vertex attributes into smaller formats
+ *
+ * \author Lauchmelder
+ * \date   January 2021
+ *********************************************************************/
+#ifndef VERTEXCOMPRESSION_HPP
+#define VERTEXCOMPRESSION_HPP
+
+#include <core.hpp>
+#include <mesh.hpp>
+
+#include <vector>
+
+namespace oglu
+{
+	class AbstractVertexEncoder;
+
+	typedef std::shared_ptr<AbstractVertexEncoder> VertexEncoder;
+
+	/**
+	 * @brief Converts a float vertex attribute into a smaller format.
+	 *
+	 * Derive from this class to add a format, the built-in ones are created with
+	 * MakeHalfFloatEncoder(), MakeOctahedralEncoder() and MakeUnorm8Encoder().
+	 */
+	class OGLU_API AbstractVertexEncoder
+	{
+	public:
+		virtual ~AbstractVertexEncoder() {}
+
+		/**
+		 * @brief Get the format of the encoded attribute, as it is passed to glVertexAttribPointer().
+		 *
+		 * @param[in] components Amount of floats of the attribute before encoding
+		 * @param[out] size Number of elements of the encoded attribute
+		 * @param[out] type Datatype of the encoded elements
+		 * @param[out] normalized Wether the encoded elements are normalized fixed-point data
+		 *
+		 * @throws std::runtime_error If the encoder can't encode this amount of components
+		 */
+		virtual void GetFormat(GLint components, GLint& size, GLenum& type, GLboolean& normalized) const = 0;
+
+		/**
+		 * @brief Get the size of an encoded attribute in bytes.
+		 *
+		 * @param[in] components Amount of floats of the attribute before encoding
+		 */
+		virtual size_t GetEncodedSize(GLint components) const = 0;
+
+		/**
+		 * @brief Encode the attribute of one vertex.
+		 *
+		 * @param[in] input The floats of the attribute
+		 * @param[in] components Amount of floats
+		 * @param[out] output Receives GetEncodedSize() bytes
+		 */
+		virtual void Encode(const GLfloat* input, GLint components, void* output) const = 0;
+
+		/**
+		 * @brief Reconstruct the attribute of one vertex the way the GPU reads it.
+		 *
+		 * @param[in] input The encoded attribute
+		 * @param[in] components Amount of floats of the attribute before encoding
+		 * @param[out] output Receives @p components floats
+		 */
+		virtual void Decode(const void* input, GLint components, GLfloat* output) const = 0;
+	};
+
+	/**
+	 * @brief Assigns an encoder to the vertex attribute at an index.
+	 */
+	struct OGLU_API AttributeEncoding
+	{
+		/*@{*/
+		GLuint index;			///< Index of the vertex attribute
+		VertexEncoder encoder;	///< Encoder converting the attribute
+		/*@}*/
+	};
+
+	/**
+	 * @brief Result of compressing a single vertex attribute.
+	 */
+	struct OGLU_API AttributeCompressionStats
+	{
+		/*@{*/
+		GLuint index;		///< Index of the vertex attribute
+		size_t sizeBefore;	///< Size of the attribute in bytes before compressing
+		size_t sizeAfter;	///< Size of the attribute in bytes after compressing, without padding
+		float maxError;		///< Largest difference of a component to the original value, 0 if the attribute wasn't encoded
+		/*@}*/
+	};
+
+	/**
+	 * @brief Result of CompressMesh().
+	 */
+	struct OGLU_API MeshCompressionReport
+	{
+		/*@{*/
+		GLsizei strideBefore;								///< Size of a vertex in bytes before compressing
+		GLsizei strideAfter;								///< Size of a vertex in bytes after compressing
+		std::vector<AttributeCompressionStats> attributes;	///< Stats of every attribute, in the order of the topology
+		/*@}*/
+	};
+
+	/**
+	 * @brief Encodes floats as 16 bit floats (GL_HALF_FLOAT).
+	 *
+	 * Suited for positions and texture coordinates, the precision is 11 significant
+	 * bits, so the error grows with the magnitude of the values.
+	 *
+	 * @return A shared pointer to the encoder.
+	 */
+	VertexEncoder OGLU_API MakeHalfFloatEncoder();
+
+	/**
+	 * @brief Encodes unit vectors as two octahedral coordinates.
+	 *
+	 * The normal is projected onto an octahedron, which is unfolded onto a square, so
+	 * only two signed normalized values are stored. Zero vectors can't be represented.
+	 * The vertex shader reads the attribute as a vec2 and has to decode it:
+	 *
+	 *		vec3 OctahedralDecode(vec2 e)
+	 *		{
+	 *			vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	 *			float t = max(-n.z, 0.0);
+	 *			n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	 *			return normalize(n);
+	 *		}
+	 *
+	 * @param[in] type GL_INT_2_10_10_10_REV to store 10 bits per coordinate, or GL_SHORT to store 16. Both need 4 bytes
+	 *
+	 * @throws std::runtime_error If @p type is neither of them
+	 *
+	 * @return A shared pointer to the encoder.
+	 */
+	VertexEncoder OGLU_API MakeOctahedralEncoder(GLenum type = GL_INT_2_10_10_10_REV);
+
+	/**
+	 * @brief Encodes values between 0 and 1 as unsigned normalized bytes.
+	 *
+	 * Suited for colors, values outside of the range are clamped.
+	 *
+	 * @return A shared pointer to the encoder.
+	 */
+	VertexEncoder OGLU_API MakeUnorm8Encoder();
+
+	/**
+	 * @brief Convert vertex attributes into smaller formats.
+	 *
+	 * Every attribute with an encoder is replaced by its encoded version, the others are
+	 * copied as they are. The topology is updated to match, every attribute starts at a
+	 * multiple of 4 bytes. Afterwards MeshData::vertices holds the packed attributes bit
+	 * for bit and can be uploaded like any other mesh.
+	 *
+	 * Since OptimizeOverdraw() needs float positions, optimize the mesh before compressing it.
+	 *
+	 * @param[in,out] mesh The mesh to compress
+	 * @param[in] encodings Array of AttributeEncoding
+	 * @param[in] encodingsSize Size of the encodings array
+	 *
+	 * @throws std::runtime_error If an encoded attribute doesn't consist of floats or an encoder doesn't support it
+	 *
+	 * @return The size of every attribute before and after, and the largest error the encoding introduced.
+	 */
+	MeshCompressionReport OGLU_API CompressMesh(MeshData& mesh, const AttributeEncoding* encodings, size_t encodingsSize);
+}
+
+#endif
@@ -0,0 +1,186 @@
+#include "buffer.hpp"
+
+#include <algorithm>
+
+namespace oglu
+{
+	AbstractBuffer::AbstractBuffer(const AbstractBuffer& other) :
+		buffer(other.buffer), size(other.size), usage(other.usage), immutable(other.immutable)
+	{
+	}
+
+	AbstractBuffer::~AbstractBuffer()
+	{
+		glDeleteBuffers(1, &buffer);
+	}
+
+	Buffer MakeBuffer(GLsizeiptr size, const void* data, GLenum usage)
+	{
+		return Buffer(new AbstractBuffer(size, data, usage));
+	}
+
+	Buffer MakeBufferStorage(GLsizeiptr size, const void* data, GLbitfield flags)
+	{
+		if (!GLAD_GL_VERSION_4_4)
+			throw std::runtime_error("Immutable buffer storage requires OpenGL 4.4");
+
+		return Buffer(new AbstractBuffer(size, data, flags, true));
+	}
+
+	AbstractBuffer::AbstractBuffer(GLsizeiptr size, const void* data, GLenum usage) :
+		buffer(0), size(size), usage(usage), immutable(false)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, data, usage);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	AbstractBuffer::AbstractBuffer(GLsizeiptr size, const void* data, GLbitfield flags, bool immutable) :
+		buffer(0), size(size), usage(GL_NONE), immutable(immutable)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, data, flags);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	void AbstractBuffer::Bind(GLenum target)
+	{
+		glBindBuffer(target, buffer);
+	}
+
+	void AbstractBuffer::Unbind(GLenum target)
+	{
+		glBindBuffer(target, 0);
+	}
+
+	void AbstractBuffer::Resize(GLsizeiptr size, bool preserve)
+	{
+		if (immutable)
+			throw std::runtime_error("Buffers with immutable storage can't be resized");
+
+		GLsizeiptr kept = preserve ? std::min(this->size, size) : 0;
+		if (kept == 0)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, usage);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+			this->size = size;
+			return;
+		}
+
+		// Reallocating the storage discards it, so the contents are parked in a temporary buffer
+		GLuint temporary;
+		glGenBuffers(1, &temporary);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, temporary);
+		glBufferData(GL_COPY_WRITE_BUFFER, kept, nullptr, GL_STREAM_COPY);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept);
+
+		glBufferData(GL_COPY_READ_BUFFER, size, nullptr, usage);
+		glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER, 0, 0, kept);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &temporary);
+
+		this->size = size;
+	}
+
+	void AbstractBuffer::SetData(const void* data, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	GLsizeiptr AbstractBuffer::GetSize() const
+	{
+		return size;
+	}
+
+	GLuint AbstractBuffer::GetHandle() const
+	{
+		return buffer;
+	}
+
+	BufferAllocator::BufferAllocator(size_t capacity) :
+		capacity(0), used(0)
+	{
+		Grow(capacity);
+	}
+
+	bool BufferAllocator::Allocate(size_t size, size_t& offset)
+	{
+		for (auto range = freeRanges.begin(); range != freeRanges.end(); range++)
+		{
+			if (range->second < size)
+				continue;
+
+			offset = range->first;
+			size_t remaining = range->second - size;
+			freeRanges.erase(range);
+			if (remaining > 0)
+				freeRanges[offset + size] = remaining;
+
+			used += size;
+			return true;
+		}
+
+		return false;
+	}
+
+	void BufferAllocator::Free(size_t offset, size_t size)
+	{
+		if (size == 0)
+			return;
+
+		used -= size;
+
+		// Merge with the free range that follows...
+		auto next = freeRanges.find(offset + size);
+		if (next != freeRanges.end())
+		{
+			size += next->second;
+			freeRanges.erase(next);
+		}
+
+		// ...and with the one that precedes the returned range
+		auto range = freeRanges.emplace(offset, size).first;
+		if (range != freeRanges.begin())
+		{
+			auto previous = std::prev(range);
+			if (previous->first + previous->second == offset)
+			{
+				previous->second += size;
+				freeRanges.erase(range);
+			}
+		}
+	}
+
+	void BufferAllocator::Grow(size_t capacity)
+	{
+		if (capacity <= this->capacity)
+			return;
+
+		size_t offset = this->capacity;
+		size_t size = capacity - this->capacity;
+		this->capacity = capacity;
+
+		// The added part is handed back like a released range, so it merges with a free tail
+		used += size;
+		Free(offset, size);
+	}
+
+	size_t BufferAllocator::GetCapacity() const
+	{
+		return capacity;
+	}
+
+	size_t BufferAllocator::GetUsed() const
+	{
+		return used;
+	}
+}
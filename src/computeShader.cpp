@@ -0,0 +1,73 @@
+#include "computeShader.hpp"
+
+namespace oglu
+{
+	ComputeShader MakeComputeShader(const char* computeShaderFile, const ShaderDefine* defines, size_t definesSize)
+	{
+		if (!GLAD_GL_VERSION_4_3)
+			throw std::runtime_error("Compute shaders require OpenGL 4.3: " + std::string(computeShaderFile));
+
+		ShaderStage stage = { GL_COMPUTE_SHADER, computeShaderFile };
+		return std::static_pointer_cast<AbstractComputeShader>(MakeShader(&stage, sizeof(stage), defines, definesSize));
+	}
+
+	AbstractComputeShader::AbstractComputeShader(GLuint program, const ShaderLoadInfo& loadInfo) :
+		AbstractShader(program, loadInfo), workGroupSize(1)
+	{
+		GLint size[3];
+		glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, size);
+		workGroupSize = glm::uvec3(size[0], size[1], size[2]);
+	}
+
+	void AbstractComputeShader::Dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ)
+	{
+		Use();
+		glDispatchCompute(groupsX, groupsY, groupsZ);
+	}
+
+	void AbstractComputeShader::DispatchInvocations(GLuint invocationsX, GLuint invocationsY, GLuint invocationsZ)
+	{
+		Dispatch(
+			(invocationsX + workGroupSize.x - 1) / workGroupSize.x,
+			(invocationsY + workGroupSize.y - 1) / workGroupSize.y,
+			(invocationsZ + workGroupSize.z - 1) / workGroupSize.z
+		);
+	}
+
+	void AbstractComputeShader::DispatchIndirect(GLuint buffer, GLintptr offset)
+	{
+		Use();
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+		glDispatchComputeIndirect(offset);
+	}
+
+	const glm::uvec3& AbstractComputeShader::GetWorkGroupSize() const
+	{
+		return workGroupSize;
+	}
+
+	void IssueMemoryBarrier(GLbitfield barriers)
+	{
+		glMemoryBarrier(barriers);
+	}
+
+	void StorageBarrier()
+	{
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	void ImageBarrier()
+	{
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+
+	void VertexBarrier()
+	{
+		glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+	}
+
+	void CommandBarrier()
+	{
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+	}
+}
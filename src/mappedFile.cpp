@@ -0,0 +1,108 @@
+#include "mappedFile.hpp"
+
+#ifdef OGLU_WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace oglu
+{
+#ifdef OGLU_WIN32
+	MappedFile::MappedFile(const char* filename) :
+		data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(NULL)
+	{
+		file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("Failed to open file: " + std::string(filename));
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			throw std::runtime_error("Failed to get size of file: " + std::string(filename));
+		}
+
+		size = (size_t)fileSize.QuadPart;
+		if (size == 0)
+			return;
+
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+			data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+		if (data == nullptr)
+		{
+			if (mapping != NULL)
+				CloseHandle(mapping);
+
+			CloseHandle(file);
+			throw std::runtime_error("Failed to map file: " + std::string(filename));
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data != nullptr)
+			UnmapViewOfFile(data);
+
+		if (mapping != NULL)
+			CloseHandle(mapping);
+
+		CloseHandle(file);
+	}
+#else
+	MappedFile::MappedFile(const char* filename) :
+		data(nullptr), size(0)
+	{
+		int file = open(filename, O_RDONLY);
+		if (file == -1)
+			throw std::runtime_error("Failed to open file: " + std::string(filename));
+
+		struct stat info;
+		if (fstat(file, &info) == -1)
+		{
+			close(file);
+			throw std::runtime_error("Failed to get size of file: " + std::string(filename));
+		}
+
+		// Mapping an empty file fails, there is nothing to read anyways
+		size = (size_t)info.st_size;
+		if (size > 0)
+		{
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapping == MAP_FAILED)
+			{
+				close(file);
+				throw std::runtime_error("Failed to map file: " + std::string(filename));
+			}
+
+			data = static_cast<const char*>(mapping);
+		}
+
+		// The mapping stays valid after the descriptor is closed
+		close(file);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data != nullptr)
+			munmap(const_cast<char*>(data), size);
+	}
+#endif
+
+	const char* MappedFile::GetData() const
+	{
+		return data;
+	}
+
+	size_t MappedFile::GetSize() const
+	{
+		return size;
+	}
+}
@@ -0,0 +1,503 @@
+#include "mesh.hpp"
+#include "mappedFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <unordered_map>
+
+namespace oglu
+{
+	/**
+	 * @brief A corner of an .obj face as it was written in the file.
+	 */
+	struct ObjCorner
+	{
+		int32_t index[3];	///< Zero based index of the position, texture coordinate and normal
+		uint8_t present;	///< Bit i is set if index[i] was given
+		uint8_t relative;	///< Bit i is set if index[i] is relative to the start of the chunk instead of the file
+	};
+
+	/**
+	 * @brief A combination of elements that makes up one vertex.
+	 */
+	struct ObjVertexKey
+	{
+		int32_t index[3];	///< Absolute index of the position, texture coordinate and normal, -1 if missing
+
+		bool operator==(const ObjVertexKey& other) const
+		{
+			return index[0] == other.index[0] && index[1] == other.index[1] && index[2] == other.index[2];
+		}
+	};
+
+	/**
+	 * @brief Hash of ObjVertexKey for std::unordered_map.
+	 */
+	struct ObjVertexKeyHash
+	{
+		size_t operator()(const ObjVertexKey& key) const
+		{
+			uint64_t hash = (uint32_t)key.index[0];
+			hash = hash * 0x9E3779B97F4A7C15ull + (uint32_t)key.index[1];
+			hash = hash * 0x9E3779B97F4A7C15ull + (uint32_t)key.index[2];
+			return (size_t)(hash ^ (hash >> 29));
+		}
+	};
+
+	/**
+	 * @brief A part of an .obj file that is parsed by one thread.
+	 */
+	struct ObjChunk
+	{
+		const char* begin;					///< First character of the chunk
+		const char* end;					///< One past the last character of the chunk, always at a line boundary
+
+		size_t counts[3];					///< Amount of positions, texture coordinates and normals in the chunk
+		size_t firsts[3];					///< Amount of positions, texture coordinates and normals in the chunks before
+		std::vector<float> elements[3];		///< Positions, texture coordinates and normals of the chunk
+		std::vector<ObjCorner> corners;		///< Corners of the triangles of the chunk, three per triangle
+
+		std::vector<GLfloat> vertices;		///< Interleaved vertices of the chunk
+		std::vector<GLuint> indices;		///< Indices into vertices
+		size_t firstVertex;					///< Amount of vertices in the chunks before
+		size_t firstIndex;					///< Amount of indices in the chunks before
+	};
+
+	/**
+	 * @brief Amount of floats per position, texture coordinate and normal.
+	 */
+	static const size_t objElementSize[3] = { 3, 2, 3 };
+
+	/**
+	 * @brief Chunks smaller than this aren't worth a thread.
+	 */
+	static const size_t objMinChunkSize = 256 * 1024;
+
+	/**
+	 * @brief Runs a function for every index on its own thread and waits for all of them.
+	 *
+	 * @throws The first exception one of the calls threw
+	 */
+	template<typename Function>
+	static void RunParallel(size_t count, Function function)
+	{
+		std::vector<std::exception_ptr> errors(count);
+		auto run = [&](size_t i)
+		{
+			try
+			{
+				function(i);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		};
+
+		// The calling thread takes the first index itself
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < count; i++)
+			workers.emplace_back(run, i);
+
+		if (count > 0)
+			run(0);
+
+		for (std::thread& worker : workers)
+			worker.join();
+
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+				std::rethrow_exception(error);
+		}
+	}
+
+	static inline bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	static inline const char* SkipSpaces(const char* c, const char* end)
+	{
+		while (c < end && (*c == ' ' || *c == '\t'))
+			c++;
+
+		return c;
+	}
+
+	/**
+	 * @brief Parses a decimal number like "-1.25e-3".
+	 *
+	 * Up to 19 significant digits are used, which is more than a float can hold.
+	 *
+	 * @return The first character after the number.
+	 */
+	static const char* ParseFloat(const char* c, const char* end, float& value)
+	{
+		static const double powers[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		c = SkipSpaces(c, end);
+
+		bool negative = false;
+		if (c < end && (*c == '-' || *c == '+'))
+			negative = (*c++ == '-');
+
+		uint64_t mantissa = 0;
+		int digits = 0;
+		int exponent = 0;
+		for (; c < end && IsDigit(*c); c++)
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*c - '0');
+				if (mantissa != 0)
+					digits++;
+			}
+			else
+			{
+				exponent++;
+			}
+		}
+
+		if (c < end && *c == '.')
+		{
+			for (c++; c < end && IsDigit(*c); c++)
+			{
+				if (digits < 19)
+				{
+					mantissa = mantissa * 10 + (*c - '0');
+					if (mantissa != 0)
+						digits++;
+					exponent--;
+				}
+			}
+		}
+
+		if (c < end && (*c == 'e' || *c == 'E'))
+		{
+			c++;
+			bool negativeExponent = false;
+			if (c < end && (*c == '-' || *c == '+'))
+				negativeExponent = (*c++ == '-');
+
+			int explicitExponent = 0;
+			for (; c < end && IsDigit(*c); c++)
+			{
+				if (explicitExponent < 10000)
+					explicitExponent = explicitExponent * 10 + (*c - '0');
+			}
+
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		}
+
+		double result = (double)mantissa;
+		if (exponent < 0 && exponent >= -22)
+			result /= powers[-exponent];
+		else if (exponent > 0 && exponent <= 22)
+			result *= powers[exponent];
+		else if (exponent != 0)
+			result *= std::pow(10.0, exponent);
+
+		value = (float)(negative ? -result : result);
+		return c;
+	}
+
+	/**
+	 * @brief Parses a signed integer.
+	 *
+	 * @return The first character after the number, @p c if there was none.
+	 */
+	static const char* ParseInt(const char* c, const char* end, int32_t& value)
+	{
+		const char* start = c;
+		bool negative = false;
+		if (c < end && (*c == '-' || *c == '+'))
+			negative = (*c++ == '-');
+
+		if (c == end || !IsDigit(*c))
+			return start;
+
+		int64_t result = 0;
+		for (; c < end && IsDigit(*c); c++)
+		{
+			if (result <= INT32_MAX)
+				result = result * 10 + (*c - '0');
+		}
+
+		value = (int32_t)std::min<int64_t>(negative ? -result : result, INT32_MAX);
+		return c;
+	}
+
+	/**
+	 * @brief Reads the elements and triangles of a chunk.
+	 */
+	static void ParseObjChunk(ObjChunk& chunk)
+	{
+		std::vector<ObjCorner> polygon;
+
+		const char* c = chunk.begin;
+		const char* end = chunk.end;
+		while (c < end)
+		{
+			const char* lineEnd = (const char*)memchr(c, '\n', end - c);
+			if (lineEnd == nullptr)
+				lineEnd = end;
+
+			c = SkipSpaces(c, lineEnd);
+			if (c + 1 < lineEnd && c[0] == 'v')
+			{
+				int element = -1;
+				if (c[1] == ' ' || c[1] == '\t')
+					element = 0;
+				else if (c[1] == 't')
+					element = 1;
+				else if (c[1] == 'n')
+					element = 2;
+
+				if (element >= 0)
+				{
+					// Anything after the required components (like the w of a position) is ignored
+					c += (element == 0) ? 1 : 2;
+					for (size_t i = 0; i < objElementSize[element]; i++)
+					{
+						float value = 0.0f;
+						c = ParseFloat(c, lineEnd, value);
+						chunk.elements[element].push_back(value);
+					}
+				}
+			}
+			else if (c + 1 < lineEnd && c[0] == 'f' && (c[1] == ' ' || c[1] == '\t'))
+			{
+				polygon.clear();
+				c++;
+				while (true)
+				{
+					c = SkipSpaces(c, lineEnd);
+					ObjCorner corner = { { 0, 0, 0 }, 0, 0 };
+					for (int i = 0; i < 3; i++)
+					{
+						int32_t index = 0;
+						const char* next = ParseInt(c, lineEnd, index);
+						if (next != c && index != 0)
+						{
+							corner.present |= 1 << i;
+							if (index < 0)
+							{
+								corner.relative |= 1 << i;
+								corner.index[i] = (int32_t)(chunk.elements[i].size() / objElementSize[i]) + index;
+							}
+							else
+							{
+								corner.index[i] = index - 1;
+							}
+						}
+
+						c = next;
+						if (i == 2 || c == lineEnd || *c != '/')
+							break;
+
+						c++;
+					}
+
+					if (!(corner.present & 1))
+						break;
+
+					polygon.push_back(corner);
+				}
+
+				for (size_t i = 2; i < polygon.size(); i++)
+				{
+					chunk.corners.push_back(polygon[0]);
+					chunk.corners.push_back(polygon[i - 1]);
+					chunk.corners.push_back(polygon[i]);
+				}
+			}
+
+			c = lineEnd + 1;
+		}
+
+		for (int i = 0; i < 3; i++)
+			chunk.counts[i] = chunk.elements[i].size() / objElementSize[i];
+	}
+
+	/**
+	 * @brief Turns the triangles of a chunk into interleaved vertices and indices.
+	 */
+	static void BuildObjVertices(ObjChunk& chunk, const std::vector<float>* elements, const bool* used, const char* filepath)
+	{
+		size_t counts[3];
+		for (int i = 0; i < 3; i++)
+			counts[i] = elements[i].size() / objElementSize[i];
+
+		std::unordered_map<ObjVertexKey, GLuint, ObjVertexKeyHash> vertices;
+		vertices.reserve(chunk.corners.size() / 2);
+		chunk.indices.reserve(chunk.corners.size());
+
+		for (const ObjCorner& corner : chunk.corners)
+		{
+			ObjVertexKey key = { { -1, -1, -1 } };
+			for (int i = 0; i < 3; i++)
+			{
+				if (!used[i] || !(corner.present & (1 << i)))
+					continue;
+
+				int64_t index = corner.index[i];
+				if (corner.relative & (1 << i))
+					index += chunk.firsts[i];
+
+				if (index < 0 || (size_t)index >= counts[i])
+					throw std::runtime_error("Face references a missing element in OBJ file: " + std::string(filepath));
+
+				key.index[i] = (int32_t)index;
+			}
+
+			auto vertex = vertices.emplace(key, (GLuint)vertices.size());
+			if (vertex.second)
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					if (!used[i])
+						continue;
+
+					if (key.index[i] < 0)
+					{
+						chunk.vertices.insert(chunk.vertices.end(), objElementSize[i], 0.0f);
+						continue;
+					}
+
+					const float* element = elements[i].data() + key.index[i] * objElementSize[i];
+					chunk.vertices.insert(chunk.vertices.end(), element, element + objElementSize[i]);
+				}
+			}
+
+			chunk.indices.push_back(vertex.first->second);
+		}
+
+		chunk.corners = std::vector<ObjCorner>();
+	}
+
+	MeshData LoadObj(const char* filepath, unsigned int threads)
+	{
+		MappedFile file(filepath);
+		const char* data = file.GetData();
+		size_t size = file.GetSize();
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads, size / objMinChunkSize));
+
+		// Split into chunks of roughly equal size that end at a line break
+		std::vector<ObjChunk> chunks(chunkCount);
+		const char* begin = data;
+		for (size_t i = 0; i < chunkCount; i++)
+		{
+			const char* end = data + size * (i + 1) / chunkCount;
+			if (end < begin)
+				end = begin;
+
+			if (i + 1 < chunkCount)
+			{
+				const char* lineEnd = (const char*)memchr(end, '\n', data + size - end);
+				end = (lineEnd != nullptr) ? lineEnd + 1 : data + size;
+			}
+
+			chunks[i].begin = begin;
+			chunks[i].end = end;
+			begin = end;
+		}
+
+		RunParallel(chunkCount, [&](size_t i) { ParseObjChunk(chunks[i]); });
+
+		// Merge the elements, relative indices are resolved with the amount of elements before each chunk
+		std::vector<float> elements[3];
+		bool used[3] = { true, false, false };
+		for (int i = 0; i < 3; i++)
+		{
+			size_t total = 0;
+			for (ObjChunk& chunk : chunks)
+			{
+				chunk.firsts[i] = total;
+				total += chunk.counts[i];
+			}
+
+			elements[i].reserve(total * objElementSize[i]);
+			for (ObjChunk& chunk : chunks)
+			{
+				elements[i].insert(elements[i].end(), chunk.elements[i].begin(), chunk.elements[i].end());
+				chunk.elements[i] = std::vector<float>();
+			}
+		}
+
+		for (const ObjChunk& chunk : chunks)
+		{
+			for (const ObjCorner& corner : chunk.corners)
+			{
+				used[1] = used[1] || (corner.present & 2);
+				used[2] = used[2] || (corner.present & 4);
+			}
+		}
+
+		// Vertices are only shared within a chunk, so corners on chunk boundaries may be duplicated
+		RunParallel(chunkCount, [&](size_t i) { BuildObjVertices(chunks[i], elements, used, filepath); });
+
+		GLsizei stride = (GLsizei)((3 + (used[1] ? 2 : 0) + (used[2] ? 3 : 0)) * sizeof(GLfloat));
+
+		MeshData mesh;
+		mesh.topology.push_back({ 0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0 });
+		if (used[1])
+			mesh.topology.push_back({ 1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(GLfloat)) });
+		if (used[2])
+			mesh.topology.push_back({ 2, 3, GL_FLOAT, GL_FALSE, stride, (void*)((used[1] ? 5 : 3) * sizeof(GLfloat)) });
+
+		size_t vertexFloats = 0, indexCount = 0;
+		for (ObjChunk& chunk : chunks)
+		{
+			chunk.firstVertex = vertexFloats;
+			chunk.firstIndex = indexCount;
+			vertexFloats += chunk.vertices.size();
+			indexCount += chunk.indices.size();
+		}
+
+		mesh.vertices.resize(vertexFloats);
+		mesh.indices.resize(indexCount);
+		RunParallel(chunkCount, [&](size_t i)
+			{
+				ObjChunk& chunk = chunks[i];
+				GLuint offset = (GLuint)(chunk.firstVertex / (stride / sizeof(GLfloat)));
+
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), mesh.vertices.begin() + chunk.firstVertex);
+				std::transform(chunk.indices.begin(), chunk.indices.end(), mesh.indices.begin() + chunk.firstIndex,
+					[offset](GLuint index) { return index + offset; });
+			}
+		);
+
+		return mesh;
+	}
+
+	GLsizei MeshData::GetStride() const
+	{
+		return topology.empty() ? 0 : topology[0].stride;
+	}
+
+	size_t MeshData::GetVertexCount() const
+	{
+		GLsizei stride = GetStride();
+		return (stride == 0) ? 0 : vertices.size() * sizeof(GLfloat) / stride;
+	}
+
+	VertexArray MakeVertexArray(const MeshData& mesh)
+	{
+		return MakeVertexArray(mesh.vertices.data(), mesh.vertices.size() * sizeof(GLfloat),
+			mesh.indices.empty() ? nullptr : mesh.indices.data(), mesh.indices.size() * sizeof(GLuint),
+			mesh.topology.data(), mesh.topology.size() * sizeof(VertexAttribute)
+		);
+	}
+}
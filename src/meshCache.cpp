@@ -0,0 +1,326 @@
+#include "meshCache.hpp"
+#include "mappedFile.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace oglu
+{
+	static const char MESH_CACHE_MAGIC[4] = { 'O', 'G', 'L', 'M' };
+	static const uint32_t MESH_CACHE_VERSION = 1;
+	static const size_t MESH_CACHE_ALIGNMENT = 64;	///< Alignment of the data blobs inside the file
+	static const uint32_t MESH_CACHE_MAX_ATTRIBUTES = 16;
+
+	static std::string meshCacheDirectory;	///< Directory of the mesh cache, empty if disabled
+
+	/**
+	 * @brief Rounds an offset up to the alignment of the data blobs.
+	 */
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+	}
+
+	/**
+	 * @brief Size of an index of the given type, 0 if the type isn't valid in a cache file.
+	 */
+	static size_t GetIndexSize(uint32_t indexType)
+	{
+		switch (indexType)
+		{
+		case GL_UNSIGNED_SHORT:	return sizeof(GLushort);
+		case GL_UNSIGNED_INT:	return sizeof(GLuint);
+		}
+
+		return 0;
+	}
+
+	/**
+	 * @brief Reads the size and last write time of a file.
+	 *
+	 * @return False if the file doesn't exist.
+	 */
+	static bool GetSourceStamp(const char* sourceFile, uint64_t& size, int64_t& time)
+	{
+		std::error_code error;
+		size = std::filesystem::file_size(sourceFile, error);
+		if (error)
+			return false;
+
+		auto writeTime = std::filesystem::last_write_time(sourceFile, error);
+		if (error)
+			return false;
+
+		time = (int64_t)writeTime.time_since_epoch().count();
+		return true;
+	}
+
+	/**
+	 * @brief Hashes the contents of a file.
+	 */
+	static uint64_t HashSourceFile(const char* sourceFile)
+	{
+		MappedFile file(sourceFile);
+		return HashBytes(file.GetData(), file.GetSize());
+	}
+
+	/**
+	 * @brief Replaces the timestamp of the source model recorded in a cache file.
+	 */
+	static void RestampMeshCache(const char* cacheFile, int64_t sourceTime)
+	{
+		std::fstream file(cacheFile, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(offsetof(MeshCacheHeader, sourceTime));
+		file.write(reinterpret_cast<const char*>(&sourceTime), sizeof(sourceTime));
+
+		if (!file.good())
+			OGLU_ERROR_STREAM << "Failed to update the timestamp of mesh cache entry " << cacheFile << std::endl;
+	}
+
+	bool WriteMeshCache(const char* cacheFile, const MeshData& mesh, const char* sourceFile)
+	{
+		if (mesh.topology.size() > MESH_CACHE_MAX_ATTRIBUTES)
+		{
+			OGLU_ERROR_STREAM << "Mesh has too many attributes for the mesh cache: " << cacheFile << std::endl;
+			return false;
+		}
+
+		MeshCacheHeader header = {};
+		memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+		header.version = MESH_CACHE_VERSION;
+
+		if (sourceFile != nullptr)
+		{
+			try
+			{
+				if (!GetSourceStamp(sourceFile, header.sourceSize, header.sourceTime))
+					throw std::runtime_error("Failed to read the size and timestamp of " + std::string(sourceFile));
+
+				header.sourceHash = HashSourceFile(sourceFile);
+			}
+			catch (const std::runtime_error& e)
+			{
+				OGLU_ERROR_STREAM << "Failed to write mesh cache entry " << cacheFile << "\n" << e.what() << std::endl;
+				return false;
+			}
+		}
+
+		header.stride = mesh.GetStride();
+		header.attributeCount = (uint32_t)mesh.topology.size();
+		header.indexType = 0;
+		if (!mesh.indices.empty())
+			header.indexType = (*std::max_element(mesh.indices.begin(), mesh.indices.end()) <= 0xFFFF) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+		header.vertexCount = mesh.GetVertexCount();
+		header.indexCount = mesh.indices.size();
+
+		// The bounds are taken from the first attribute, if it holds float positions
+		if (!mesh.topology.empty() && mesh.topology[0].type == GL_FLOAT && mesh.topology[0].size >= 3 && header.vertexCount > 0)
+		{
+			size_t stride = header.stride / sizeof(GLfloat);
+			const GLfloat* position = mesh.vertices.data() + (size_t)mesh.topology[0].pointer / sizeof(GLfloat);
+			for (int i = 0; i < 3; i++)
+				header.boundsMin[i] = header.boundsMax[i] = position[i];
+
+			for (size_t vertex = 0; vertex < header.vertexCount; vertex++, position += stride)
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					header.boundsMin[i] = std::min(header.boundsMin[i], position[i]);
+					header.boundsMax[i] = std::max(header.boundsMax[i], position[i]);
+				}
+			}
+		}
+
+		header.vertexSize = mesh.vertices.size() * sizeof(GLfloat);
+		header.vertexOffset = AlignOffset(sizeof(MeshCacheHeader) + header.attributeCount * sizeof(MeshCacheAttribute));
+		header.indexSize = mesh.indices.size() * GetIndexSize(header.indexType);
+		header.indexOffset = AlignOffset(header.vertexOffset + header.vertexSize);
+
+		// Indices are stored in the type they're drawn with, so loading never has to convert them
+		std::vector<GLushort> shortIndices;
+		const void* indexData = mesh.indices.data();
+		if (header.indexType == GL_UNSIGNED_SHORT)
+		{
+			shortIndices.assign(mesh.indices.begin(), mesh.indices.end());
+			indexData = shortIndices.data();
+		}
+
+		std::vector<MeshCacheAttribute> attributes;
+		for (const VertexAttribute& attribute : mesh.topology)
+			attributes.push_back({ attribute.index, attribute.size, attribute.type, attribute.normalized, (uint64_t)(size_t)attribute.pointer });
+
+		// Write to a temporary file first, so a crash never leaves a truncated entry behind
+		std::string temporaryFile = std::string(cacheFile) + ".tmp";
+		{
+			std::ofstream file(temporaryFile, std::ios::binary | std::ios::trunc);
+			if (!file.good())
+			{
+				OGLU_ERROR_STREAM << "Failed to write mesh cache entry " << cacheFile << std::endl;
+				return false;
+			}
+
+			static const char padding[MESH_CACHE_ALIGNMENT] = {};
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(attributes.data()), attributes.size() * sizeof(MeshCacheAttribute));
+			file.write(padding, header.vertexOffset - sizeof(header) - attributes.size() * sizeof(MeshCacheAttribute));
+			file.write(reinterpret_cast<const char*>(mesh.vertices.data()), header.vertexSize);
+			file.write(padding, header.indexOffset - header.vertexOffset - header.vertexSize);
+			file.write(reinterpret_cast<const char*>(indexData), header.indexSize);
+
+			if (!file.good())
+			{
+				OGLU_ERROR_STREAM << "Failed to write mesh cache entry " << cacheFile << std::endl;
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporaryFile, cacheFile, error);
+		if (error)
+		{
+			OGLU_ERROR_STREAM << "Failed to write mesh cache entry " << cacheFile << ": " << error.message() << std::endl;
+			std::filesystem::remove(temporaryFile, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	VertexArray MakeVertexArrayFromCache(const char* cacheFile, const char* sourceFile)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(cacheFile, error))
+			return nullptr;
+
+		std::unique_ptr<MappedFile> file;
+		try
+		{
+			file.reset(new MappedFile(cacheFile));
+		}
+		catch (const std::runtime_error& e)
+		{
+			OGLU_ERROR_STREAM << e.what() << std::endl;
+			return nullptr;
+		}
+
+		const char* data = file->GetData();
+		size_t size = file->GetSize();
+
+		MeshCacheHeader header;
+		if (size < sizeof(header))
+			return nullptr;
+
+		memcpy(&header, data, sizeof(header));
+		if (memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != MESH_CACHE_VERSION)
+			return nullptr;
+
+		// Sizes are compared by dividing, so huge counts can't overflow into a match
+		size_t indexSize = GetIndexSize(header.indexType);
+		bool valid =
+			header.attributeCount > 0 && header.attributeCount <= MESH_CACHE_MAX_ATTRIBUTES &&
+			header.stride >= sizeof(GLfloat) && header.stride % sizeof(GLfloat) == 0 &&
+			sizeof(header) + header.attributeCount * sizeof(MeshCacheAttribute) <= header.vertexOffset &&
+			header.vertexOffset <= size && header.vertexSize <= size - header.vertexOffset &&
+			header.indexOffset <= size && header.indexSize <= size - header.indexOffset &&
+			header.vertexCount > 0 && header.vertexSize % header.stride == 0 && header.vertexCount == header.vertexSize / header.stride &&
+			((header.indexType == 0) ? (header.indexSize == 0) : (indexSize != 0 && header.indexSize % indexSize == 0 && header.indexCount == header.indexSize / indexSize));
+
+		VertexAttribute topology[MESH_CACHE_MAX_ATTRIBUTES];
+		const char* attributes = data + sizeof(header);
+		for (uint32_t i = 0; valid && i < header.attributeCount; i++)
+		{
+			MeshCacheAttribute attribute;
+			memcpy(&attribute, attributes + i * sizeof(MeshCacheAttribute), sizeof(attribute));
+			topology[i] = { attribute.index, attribute.size, attribute.type, (GLboolean)attribute.normalized, (GLsizei)header.stride, (const GLvoid*)(size_t)attribute.offset };
+
+			// Every attribute has to lie within the vertex
+			size_t attributeSize = GetVertexAttributeSize(topology[i]);
+			valid = attribute.size >= 1 && attribute.size <= 4 && attributeSize != 0 &&
+				attribute.offset <= header.stride && attributeSize <= header.stride - attribute.offset;
+		}
+
+		if (!valid)
+		{
+			OGLU_ERROR_STREAM << "Mesh cache entry " << cacheFile << " is corrupt, ignoring it." << std::endl;
+			return nullptr;
+		}
+
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		bool restamp = false;
+		if (sourceFile != nullptr)
+		{
+			if (!GetSourceStamp(sourceFile, sourceSize, sourceTime) || sourceSize != header.sourceSize)
+				return nullptr;
+
+			// A new timestamp doesn't mean new contents, e.g. after a checkout
+			if (sourceTime != header.sourceTime)
+			{
+				try
+				{
+					if (HashSourceFile(sourceFile) != header.sourceHash)
+						return nullptr;
+				}
+				catch (const std::runtime_error&)
+				{
+					return nullptr;
+				}
+
+				restamp = true;
+			}
+		}
+
+		// The mapping is handed to the driver as it is
+		VertexArray vao = MakeVertexArray(
+			reinterpret_cast<const GLfloat*>(data + header.vertexOffset), header.vertexSize,
+			(header.indexType == 0) ? nullptr : data + header.indexOffset, header.indexSize, header.indexType,
+			topology, header.attributeCount * sizeof(VertexAttribute)
+		);
+
+		// Otherwise every later load would hash the model again. The file can only be written once it's unmapped
+		if (restamp)
+		{
+			file.reset();
+			RestampMeshCache(cacheFile, sourceTime);
+		}
+
+		return vao;
+	}
+
+	void SetMeshCacheDirectory(const char* directory)
+	{
+		if (directory == nullptr)
+		{
+			meshCacheDirectory.clear();
+			return;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+			throw std::runtime_error("Failed to create mesh cache directory " + std::string(directory) + ": " + error.message());
+
+		meshCacheDirectory = directory;
+	}
+
+	std::string GetMeshCacheFile(const char* sourceFile)
+	{
+		if (meshCacheDirectory.empty())
+			return std::string();
+
+		// Entries are named after the path, so the same model is found no matter how it's spelled
+		std::error_code error;
+		std::string path = std::filesystem::weakly_canonical(sourceFile, error).string();
+		if (error)
+			path = sourceFile;
+
+		char keyString[17];
+		snprintf(keyString, sizeof(keyString), "%016llx", (unsigned long long)HashBytes(path.data(), path.size()));
+		return meshCacheDirectory + "/" + keyString + ".mesh";
+	}
+}
@@ -0,0 +1,371 @@
+#include "meshOptimizer.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <glm/glm.hpp>
+
+namespace oglu
+{
+	/**
+	 * @brief A FIFO post-transform vertex cache.
+	 *
+	 * A vertex is cached if less than cacheSize misses happened since it was last
+	 * transformed, which is exactly what a FIFO of that size keeps.
+	 */
+	class VertexCacheSimulation
+	{
+	public:
+		VertexCacheSimulation(size_t vertexCount, unsigned int cacheSize) :
+			timestamps(vertexCount, 0), time(cacheSize + 1), cacheSize(cacheSize)
+		{
+		}
+
+		/**
+		 * @brief Accesses a vertex.
+		 *
+		 * @return True if the vertex had to be transformed.
+		 */
+		bool Access(GLuint vertex)
+		{
+			if (time - timestamps[vertex] <= cacheSize)
+				return false;
+
+			timestamps[vertex] = time++;
+			return true;
+		}
+
+		/**
+		 * @brief Accesses the vertices of a triangle.
+		 *
+		 * @return The amount of vertices that had to be transformed.
+		 */
+		unsigned int AccessTriangle(const GLuint* triangle)
+		{
+			return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+		}
+
+		/**
+		 * @brief Empties the cache.
+		 */
+		void Flush()
+		{
+			time += cacheSize + 1;
+		}
+
+		/**
+		 * @brief Get the amount of misses since the vertex was last transformed.
+		 */
+		unsigned int GetAge(GLuint vertex) const
+		{
+			return time - timestamps[vertex];
+		}
+
+	private:
+		std::vector<unsigned int> timestamps;	///< Value of time when each vertex was last transformed
+		unsigned int time;						///< Amount of misses so far, offset so that no vertex starts out cached
+		unsigned int cacheSize;					///< Amount of vertices the cache holds
+	};
+
+	/**
+	 * @brief Lists the triangles that use each vertex.
+	 */
+	struct TriangleAdjacency
+	{
+		std::vector<GLuint> offsets;	///< Index of the first entry of each vertex in triangles, plus the total at the end
+		std::vector<GLuint> triangles;	///< Triangles of all vertices, grouped by vertex
+
+		TriangleAdjacency(const std::vector<GLuint>& indices, size_t vertexCount) :
+			offsets(vertexCount + 1, 0), triangles(indices.size())
+		{
+			for (GLuint index : indices)
+				offsets[index + 1]++;
+
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+			std::vector<GLuint> filled(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				triangles[filled[indices[i]]++] = (GLuint)(i / 3);
+		}
+	};
+
+	/**
+	 * @brief Finds the attribute holding the positions.
+	 *
+	 * @return Offset of the positions into a vertex in floats, or -1 if there are no float positions.
+	 */
+	static long GetPositionOffset(const MeshData& mesh)
+	{
+		for (const VertexAttribute& attribute : mesh.topology)
+		{
+			if (attribute.index == 0 && attribute.type == GL_FLOAT && attribute.size >= 3)
+				return (long)((size_t)attribute.pointer / sizeof(GLfloat));
+		}
+
+		return -1;
+	}
+
+	VertexCacheStats AnalyzeVertexCache(const MeshData& mesh, unsigned int cacheSize)
+	{
+		size_t vertexCount = mesh.GetVertexCount();
+		VertexCacheStats stats = { 0.0f, 0.0f };
+		if (mesh.indices.empty() || vertexCount == 0)
+			return stats;
+
+		VertexCacheSimulation cache(vertexCount, cacheSize);
+		size_t misses = 0;
+		for (GLuint index : mesh.indices)
+			misses += cache.Access(index);
+
+		stats.acmr = (float)misses / (float)(mesh.indices.size() / 3);
+		stats.atvr = (float)misses / (float)vertexCount;
+		return stats;
+	}
+
+	void OptimizeVertexCache(MeshData& mesh, unsigned int cacheSize)
+	{
+		size_t vertexCount = mesh.GetVertexCount();
+		size_t triangleCount = mesh.indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		TriangleAdjacency adjacency(mesh.indices, vertexCount);
+
+		std::vector<unsigned int> liveTriangles(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+			liveTriangles[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<GLuint> deadEnds;
+		std::vector<GLuint> candidates;
+		std::vector<GLuint> result;
+		result.reserve(mesh.indices.size());
+
+		VertexCacheSimulation cache(vertexCount, cacheSize);
+		size_t nextVertex = 0;	// Cursor for restarting once the dead end stack is exhausted too
+
+		long fan = mesh.indices[0];
+		while (fan >= 0)
+		{
+			// Emit every remaining triangle around the fanning vertex
+			candidates.clear();
+			for (GLuint i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; i++)
+			{
+				GLuint triangle = adjacency.triangles[i];
+				if (emitted[triangle])
+					continue;
+
+				emitted[triangle] = true;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					GLuint vertex = mesh.indices[triangle * 3 + corner];
+					result.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					liveTriangles[vertex]--;
+					cache.Access(vertex);
+				}
+			}
+
+			// The next fan is the candidate that is oldest in the cache, but will still be cached after its fan is emitted
+			fan = -1;
+			unsigned int bestPriority = 0;
+			for (GLuint vertex : candidates)
+			{
+				if (liveTriangles[vertex] == 0)
+					continue;
+
+				unsigned int priority = 1;
+				unsigned int age = cache.GetAge(vertex);
+				if (age + 2 * liveTriangles[vertex] <= cacheSize)
+					priority = age + 1;
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					fan = vertex;
+				}
+			}
+
+			if (fan >= 0)
+				continue;
+
+			// Dead end, continue with a recently used vertex or with the next one in input order
+			while (!deadEnds.empty() && fan < 0)
+			{
+				GLuint vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (liveTriangles[vertex] > 0)
+					fan = vertex;
+			}
+
+			while (nextVertex < vertexCount && fan < 0)
+			{
+				if (liveTriangles[nextVertex] > 0)
+					fan = (long)nextVertex;
+
+				nextVertex++;
+			}
+		}
+
+		mesh.indices.swap(result);
+	}
+
+	void OptimizeOverdraw(MeshData& mesh, unsigned int cacheSize, float threshold)
+	{
+		size_t vertexCount = mesh.GetVertexCount();
+		size_t triangleCount = mesh.indices.size() / 3;
+		long positionOffset = GetPositionOffset(mesh);
+		if (triangleCount == 0 || positionOffset < 0)
+			return;
+
+		const GLuint* indices = mesh.indices.data();
+		VertexCacheSimulation cache(vertexCount, cacheSize);
+
+		// Hard boundaries are where the order jumps and all three vertices miss
+		std::vector<size_t> hardBoundaries;
+		for (size_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			if (cache.AccessTriangle(indices + triangle * 3) == 3 || triangle == 0)
+				hardBoundaries.push_back(triangle);
+		}
+
+		hardBoundaries.push_back(triangleCount);
+
+		// Soft boundaries split the hard clusters wherever they are locally efficient enough, so a flush costs little
+		std::vector<size_t> clusters;
+		for (size_t i = 0; i + 1 < hardBoundaries.size(); i++)
+		{
+			size_t start = hardBoundaries[i];
+			size_t end = hardBoundaries[i + 1];
+
+			cache.Flush();
+			unsigned int clusterMisses = 0;
+			for (size_t triangle = start; triangle < end; triangle++)
+				clusterMisses += cache.AccessTriangle(indices + triangle * 3);
+
+			float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+			clusters.push_back(start);
+			cache.Flush();
+			unsigned int runningMisses = 0;
+			unsigned int runningTriangles = 0;
+			for (size_t triangle = start; triangle + 1 < end; triangle++)
+			{
+				runningMisses += cache.AccessTriangle(indices + triangle * 3);
+				runningTriangles++;
+
+				if ((float)runningMisses / (float)runningTriangles <= clusterThreshold)
+				{
+					clusters.push_back(triangle + 1);
+					cache.Flush();
+					runningMisses = 0;
+					runningTriangles = 0;
+				}
+			}
+		}
+
+		clusters.push_back(triangleCount);
+
+		// Area weighted centroid and normal of every cluster
+		size_t stride = mesh.GetStride() / sizeof(GLfloat);
+		auto position = [&](GLuint vertex)
+		{
+			const GLfloat* data = mesh.vertices.data() + vertex * stride + positionOffset;
+			return glm::vec3(data[0], data[1], data[2]);
+		};
+
+		size_t clusterCount = clusters.size() - 1;
+		std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+		std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			float clusterArea = 0.0f;
+			for (size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; triangle++)
+			{
+				glm::vec3 a = position(indices[triangle * 3 + 0]);
+				glm::vec3 b = position(indices[triangle * 3 + 1]);
+				glm::vec3 c = position(indices[triangle * 3 + 2]);
+
+				glm::vec3 normal = glm::cross(b - a, c - a);
+				float area = glm::length(normal);
+
+				centroids[cluster] += (a + b + c) * (area / 3.0f);
+				normals[cluster] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += centroids[cluster];
+			meshArea += clusterArea;
+
+			if (clusterArea > 0.0f)
+				centroids[cluster] /= clusterArea;
+		}
+
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		// Clusters facing away from the center are likely in front of the others
+		std::vector<float> keys(clusterCount);
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			float length = glm::length(normals[cluster]);
+			keys[cluster] = (length > 0.0f) ? glm::dot(centroids[cluster] - meshCentroid, normals[cluster] / length) : 0.0f;
+		}
+
+		std::vector<size_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+		std::vector<GLuint> result;
+		result.reserve(mesh.indices.size());
+		for (size_t cluster : order)
+			result.insert(result.end(), indices + clusters[cluster] * 3, indices + clusters[cluster + 1] * 3);
+
+		mesh.indices.swap(result);
+	}
+
+	void OptimizeVertexFetch(MeshData& mesh)
+	{
+		size_t vertexCount = mesh.GetVertexCount();
+		size_t stride = mesh.GetStride() / sizeof(GLfloat);
+		if (mesh.indices.empty() || stride == 0)
+			return;
+
+		const GLuint unused = (GLuint)-1;
+		std::vector<GLuint> remap(vertexCount, unused);
+		std::vector<GLfloat> vertices;
+		vertices.reserve(mesh.vertices.size());
+
+		for (GLuint& index : mesh.indices)
+		{
+			if (remap[index] == unused)
+			{
+				remap[index] = (GLuint)(vertices.size() / stride);
+				vertices.insert(vertices.end(), mesh.vertices.begin() + index * stride, mesh.vertices.begin() + (index + 1) * stride);
+			}
+
+			index = remap[index];
+		}
+
+		mesh.vertices.swap(vertices);
+	}
+
+	MeshOptimizationReport OptimizeMesh(MeshData& mesh, bool reduceOverdraw, unsigned int cacheSize)
+	{
+		MeshOptimizationReport report;
+		report.before = AnalyzeVertexCache(mesh, cacheSize);
+
+		OptimizeVertexCache(mesh, cacheSize);
+		if (reduceOverdraw)
+			OptimizeOverdraw(mesh, cacheSize);
+
+		// Runs last, the triangle order decides the order of the vertices
+		OptimizeVertexFetch(mesh);
+
+		report.after = AnalyzeVertexCache(mesh, cacheSize);
+		return report;
+	}
+}
@@ -0,0 +1,116 @@
+#include "meshPool.hpp"
+#include "stateTracker.hpp"
+
+#include <algorithm>
+
+namespace oglu
+{
+	MeshPool MakeMeshPool(const VertexAttribute* topology, size_t topologySize, size_t vertexCapacity, size_t indexCapacity, GLenum indexType)
+	{
+		if (topologySize < sizeof(VertexAttribute) || topology[0].stride == 0)
+			throw std::runtime_error("Mesh pools require a topology with an explicit stride");
+
+		if (indexType != GL_UNSIGNED_SHORT && indexType != GL_UNSIGNED_INT)
+			throw std::runtime_error("Mesh pools require GL_UNSIGNED_SHORT or GL_UNSIGNED_INT indices");
+
+		return MeshPool(new AbstractMeshPool(topology, topologySize, vertexCapacity, indexCapacity, indexType));
+	}
+
+	AbstractMeshPool::AbstractMeshPool(const VertexAttribute* topology, size_t topologySize, size_t vertexCapacity, size_t indexCapacity, GLenum indexType) :
+		VAO(0), stride(topology[0].stride), indexType(indexType), vertices(vertexCapacity), indices(indexCapacity)
+	{
+		vertexBuffer = MakeBuffer(vertexCapacity * stride);
+		indexBuffer = MakeBuffer(indexCapacity * AbstractVertexArray::GetIndexSize(indexType));
+		VAO = AbstractVertexArray::SetupVertexArray(vertexBuffer, indexBuffer, topology, topologySize);
+	}
+
+	AbstractMeshPool::~AbstractMeshPool()
+	{
+		StateTracker::Current().OnDeleteVertexArray(VAO);
+		glDeleteVertexArrays(1, &VAO);
+	}
+
+	VertexArray AbstractMeshPool::Add(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize)
+	{
+		return Add(vertices, verticesSize, indices, indicesSize, GL_UNSIGNED_INT);
+	}
+
+	VertexArray AbstractMeshPool::Add(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType)
+	{
+		size_t vertexCount = verticesSize / stride;
+		size_t indexCount = (indices != nullptr) ? indicesSize / AbstractVertexArray::GetIndexSize(indexType) : 0;
+
+		// Checked before anything is reserved, so a failing mesh doesn't leak its ranges
+		std::vector<unsigned char> storage;
+		const GLvoid* indexData = nullptr;
+		if (indices != nullptr)
+		{
+			if (this->indexType == GL_UNSIGNED_SHORT && AbstractVertexArray::GetMaxIndex(indices, indexCount, indexType) > 0xFFFF)
+				throw std::runtime_error("Mesh has indices that don't fit into the 16 bit indices of the mesh pool");
+
+			indexData = AbstractVertexArray::ConvertIndices(indices, indexCount, indexType, this->indexType, storage);
+		}
+
+		size_t firstVertex = Reserve(this->vertices, vertexBuffer, stride, vertexCount);
+		vertexBuffer->SetData(vertices, firstVertex * stride, vertexCount * stride);
+
+		size_t indexSize = AbstractVertexArray::GetIndexSize(this->indexType);
+		size_t firstIndex = 0;
+		if (indices != nullptr)
+		{
+			firstIndex = Reserve(this->indices, indexBuffer, indexSize, indexCount);
+			indexBuffer->SetData(indexData, firstIndex * indexSize, indexCount * indexSize);
+		}
+
+		// Copies of the VAO share this, the last one to go gives the ranges back
+		MeshPool pool = shared_from_this();
+		std::shared_ptr<void> ranges(pool.get(), [pool, firstVertex, vertexCount, firstIndex, indexCount](void*)
+			{
+				pool->vertices.Free(firstVertex, vertexCount);
+				pool->indices.Free(firstIndex, indexCount);
+			}
+		);
+
+		return VertexArray(new AbstractVertexArray(VAO, vertexBuffer, (indices != nullptr) ? indexBuffer : nullptr,
+			(GLint)firstVertex, (GLsizei)firstIndex, (GLsizei)((indices != nullptr) ? indexCount : vertexCount), this->indexType, ranges));
+	}
+
+	const Buffer& AbstractMeshPool::GetVertexBuffer() const
+	{
+		return vertexBuffer;
+	}
+
+	const Buffer& AbstractMeshPool::GetIndexBuffer() const
+	{
+		return indexBuffer;
+	}
+
+	size_t AbstractMeshPool::GetVertexCount() const
+	{
+		return vertices.GetUsed();
+	}
+
+	size_t AbstractMeshPool::GetIndexCount() const
+	{
+		return indices.GetUsed();
+	}
+
+	GLenum AbstractMeshPool::GetIndexType() const
+	{
+		return indexType;
+	}
+
+	size_t AbstractMeshPool::Reserve(BufferAllocator& allocator, const Buffer& buffer, size_t elementSize, size_t count)
+	{
+		size_t offset;
+		if (allocator.Allocate(count, offset))
+			return offset;
+
+		// Doubling keeps the amount of copies low when many meshes are added one by one
+		allocator.Grow(std::max(allocator.GetCapacity() * 2, allocator.GetCapacity() + count));
+		buffer->Resize(allocator.GetCapacity() * elementSize);
+
+		allocator.Allocate(count, offset);
+		return offset;
+	}
+}
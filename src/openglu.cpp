@@ -2,15 +2,42 @@
 
 #include <iostream>
 #include <exception>
+#include <cstring>
 
 namespace oglu
 {
+	static GLADloadproc loader = nullptr;	///< The loader passed to LoadGLLoader
+
 	void LoadGLLoader(GLADloadproc proc)
 	{
 		if (!gladLoadGLLoader(proc))
 		{
 			throw std::runtime_error("Failed to initialize GLAD");
 		}
+
+		loader = proc;
+	}
+
+	bool HasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; i++)
+		{
+			const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+			if (extension != nullptr && strcmp(extension, name) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	void* GetGLProcAddress(const char* name)
+	{
+		if (loader == nullptr)
+			return nullptr;
+
+		return loader(name);
 	}
 
 	void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
@@ -0,0 +1,146 @@
+#include "pipeline.hpp"
+
+#include <stateTracker.hpp>
+
+#include <map>
+#include <vector>
+
+namespace oglu
+{
+	static const GLbitfield STAGE_BITS[6] = {
+		GL_VERTEX_SHADER_BIT, GL_TESS_CONTROL_SHADER_BIT, GL_TESS_EVALUATION_SHADER_BIT,
+		GL_GEOMETRY_SHADER_BIT, GL_FRAGMENT_SHADER_BIT, GL_COMPUTE_SHADER_BIT
+	};
+
+	static const GLenum STAGE_TYPES[6] = {
+		GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER,
+		GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER, GL_COMPUTE_SHADER
+	};
+
+	static std::map<std::array<GLuint, 6>, std::weak_ptr<AbstractPipeline>> livePipelines;	///< Pipelines that are alive, by the programs of their stages
+
+	Pipeline MakePipeline(const Shader* stages, size_t stagesSize)
+	{
+		if (!GLAD_GL_VERSION_4_1)
+			throw std::runtime_error("Program pipelines require OpenGL 4.1");
+
+		// Sort the programs into stage slots, so the order they were passed in doesn't matter
+		std::array<Shader, 6> programs;
+		AbstractPipeline::StageKey key;
+		AbstractPipeline::SortStages(stages, stagesSize / sizeof(Shader), programs, key);
+
+		auto live = livePipelines.find(key);
+		if (live != livePipelines.end())
+		{
+			Pipeline pipeline = live->second.lock();
+			if (pipeline)
+				return pipeline;
+		}
+
+		Pipeline pipeline(new AbstractPipeline(programs, key));
+		livePipelines[key] = pipeline;
+		return pipeline;
+	}
+
+	Pipeline MakePipeline(const Shader& vertexStage, const Shader& fragmentStage)
+	{
+		Shader stages[] = { vertexStage, fragmentStage };
+		return MakePipeline(stages, sizeof(stages));
+	}
+
+	void AbstractPipeline::SortStages(const Shader* stages, size_t stagesSize, std::array<Shader, 6>& programs, StageKey& key)
+	{
+		key.fill(0);
+		for (size_t i = 0; i < stagesSize; i++)
+		{
+			const Shader& shader = stages[i];
+			if (!shader->IsSeparable())
+				throw std::runtime_error("Program " + std::to_string(shader->program) + " is not separable and can't be part of a pipeline");
+
+			for (size_t slot = 0; slot < programs.size(); slot++)
+			{
+				if (!(shader->GetStages() & STAGE_BITS[slot]))
+					continue;
+
+				if (programs[slot])
+					throw std::runtime_error("Programs " + std::to_string(programs[slot]->program) + " and " + std::to_string(shader->program) + " provide the same stage");
+
+				programs[slot] = shader;
+				key[slot] = shader->program;
+			}
+		}
+	}
+
+	AbstractPipeline::AbstractPipeline(const std::array<Shader, 6>& programs, const StageKey& key) :
+		pipeline(0), programs(programs), key(key), stages(0)
+	{
+		glGenProgramPipelines(1, &pipeline);
+
+		// Programs may contain several stages, each is only attached once
+		for (const Shader& program : programs)
+		{
+			if (!program || (stages & program->GetStages()))
+				continue;
+
+			glUseProgramStages(pipeline, program->GetStages(), program->program);
+			stages |= program->GetStages();
+		}
+	}
+
+	AbstractPipeline::~AbstractPipeline()
+	{
+		auto live = livePipelines.find(key);
+		if (live != livePipelines.end() && live->second.expired())
+			livePipelines.erase(live);
+
+		StateTracker::Current().OnDeleteProgramPipeline(pipeline);
+		glDeleteProgramPipelines(1, &pipeline);
+	}
+
+	void AbstractPipeline::Bind()
+	{
+		// A program in use takes precedence over the bound pipeline
+		StateTracker::Current().UseProgram(0);
+		StateTracker::Current().BindProgramPipeline(pipeline);
+	}
+
+	void AbstractPipeline::Unbind()
+	{
+		StateTracker::Current().BindProgramPipeline(0);
+	}
+
+	bool AbstractPipeline::Validate()
+	{
+		glValidateProgramPipeline(pipeline);
+
+		GLint valid = GL_FALSE;
+		glGetProgramPipelineiv(pipeline, GL_VALIDATE_STATUS, &valid);
+		if (!valid)
+		{
+			GLint length = 0;
+			glGetProgramPipelineiv(pipeline, GL_INFO_LOG_LENGTH, &length);
+
+			std::vector<GLchar> infoLog(length + 1, '\0');
+			glGetProgramPipelineInfoLog(pipeline, length, nullptr, infoLog.data());
+			OGLU_ERROR_STREAM << "Program pipeline " << pipeline << " failed to validate.\n" << infoLog.data() << std::endl;
+		}
+
+		return valid;
+	}
+
+	Shader AbstractPipeline::GetStage(GLenum type) const
+	{
+		for (size_t slot = 0; slot < programs.size(); slot++)
+		{
+			if (STAGE_TYPES[slot] == type)
+				return programs[slot];
+		}
+
+		return nullptr;
+	}
+
+	GLbitfield AbstractPipeline::GetStages() const
+	{
+		return stages;
+	}
+}
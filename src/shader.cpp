@@ -1,9 +1,18 @@
 #include <shader.hpp>
+#include <computeShader.hpp>
+#include <openglu.hpp>
+#include <stateTracker.hpp>
+#include <mappedFile.hpp>
 
 #include <fstream>
 #include <string>
 #include <algorithm>
 #include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
 
 #include <color.hpp>
 #include <texture.hpp>
@@ -14,257 +23,1512 @@
 
 namespace oglu
 {
+	// GL_KHR_parallel_shader_compile and GL_ARB_parallel_shader_compile aren't part of the bundled loader
+#ifndef GL_COMPLETION_STATUS_KHR
+	#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+	static const char PROGRAM_BINARY_MAGIC[4] = { 'O', 'G', 'L', 'B' };
+	static const uint32_t SPIRV_MAGIC = 0x07230203;	///< First word of every SPIR-V module
+	static const unsigned int MAX_INCLUDE_DEPTH = 64;	///< Deepest nesting of #include before a missing guard is assumed
+
+	/**
+	 * @brief Header in front of every program binary in the shader cache.
+	 */
+	struct ProgramBinaryHeader
+	{
+		char magic[4];		///< Always PROGRAM_BINARY_MAGIC
+		GLenum format;		///< Binary format reported by glGetProgramBinary
+		GLuint length;		///< Size of the binary following the header
+		uint64_t key;		///< Cache key the binary was stored under
+	};
+
+	static std::string shaderCacheDirectory;	///< Directory of the program binary cache, empty if disabled
+	static std::vector<std::string> shaderIncludePaths;	///< Directories searched by #include
+	static std::unordered_map<uint64_t, std::weak_ptr<AbstractShader>> liveVariants;	///< Programs that are alive, by hash of their preprocessed sources
+
+	/**
+	 * @brief 64 bit FNV-1a hash of a uniform name, also yields its length.
+	 */
+	static uint64_t HashUniformName(const GLchar* name, size_t& length)
+	{
+		uint64_t hash = FNV_OFFSET_BASIS;
+		const GLchar* it = name;
+		for (; *it != '\0'; it++)
+		{
+			hash ^= (unsigned char)(*it);
+			hash *= FNV_PRIME;
+		}
+
+		length = it - name;
+		return hash;
+	}
+
+	/**
+	 * @brief Size in bytes of a single element of a uniform type in the default block.
+	 * 
+	 * Returns 0 for types that can't be set through AbstractShader (e.g. doubles).
+	 */
+	static GLuint GetUniformTypeSize(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_FLOAT:	case GL_INT:	case GL_UNSIGNED_INT:	case GL_BOOL:		return 4;
+		case GL_FLOAT_VEC2:	case GL_INT_VEC2:	case GL_UNSIGNED_INT_VEC2:	case GL_BOOL_VEC2:	return 8;
+		case GL_FLOAT_VEC3:	case GL_INT_VEC3:	case GL_UNSIGNED_INT_VEC3:	case GL_BOOL_VEC3:	return 12;
+		case GL_FLOAT_VEC4:	case GL_INT_VEC4:	case GL_UNSIGNED_INT_VEC4:	case GL_BOOL_VEC4:	return 16;
+		case GL_FLOAT_MAT2:		return 16;
+		case GL_FLOAT_MAT3:		return 36;
+		case GL_FLOAT_MAT4:		return 64;
+		case GL_FLOAT_MAT2x3:	case GL_FLOAT_MAT3x2:	return 24;
+		case GL_FLOAT_MAT2x4:	case GL_FLOAT_MAT4x2:	return 32;
+		case GL_FLOAT_MAT3x4:	case GL_FLOAT_MAT4x3:	return 48;
+
+		case GL_DOUBLE:	case GL_DOUBLE_VEC2:	case GL_DOUBLE_VEC3:	case GL_DOUBLE_VEC4:
+		case GL_DOUBLE_MAT2:	case GL_DOUBLE_MAT3:	case GL_DOUBLE_MAT4:
+		case GL_DOUBLE_MAT2x3:	case GL_DOUBLE_MAT2x4:	case GL_DOUBLE_MAT3x2:
+		case GL_DOUBLE_MAT3x4:	case GL_DOUBLE_MAT4x2:	case GL_DOUBLE_MAT4x3:
+			return 0;
+
+		default:	return 4;	// Samplers and images
+		}
+	}
+
+	/**
+	 * @brief Component type that is used to read a uniform type back from a program.
+	 */
+	static GLenum GetUniformComponentType(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_FLOAT:	case GL_FLOAT_VEC2:	case GL_FLOAT_VEC3:	case GL_FLOAT_VEC4:
+		case GL_FLOAT_MAT2:		case GL_FLOAT_MAT3:		case GL_FLOAT_MAT4:
+		case GL_FLOAT_MAT2x3:	case GL_FLOAT_MAT2x4:	case GL_FLOAT_MAT3x2:
+		case GL_FLOAT_MAT3x4:	case GL_FLOAT_MAT4x2:	case GL_FLOAT_MAT4x3:
+			return GL_FLOAT;
+
+		case GL_UNSIGNED_INT:	case GL_UNSIGNED_INT_VEC2:	case GL_UNSIGNED_INT_VEC3:	case GL_UNSIGNED_INT_VEC4:
+			return GL_UNSIGNED_INT;
+
+		default:	return GL_INT;	// Ints, bools, samplers and images
+		}
+	}
+
 	AbstractShader::AbstractShader(const AbstractShader& other) :
-		program(other.program)
+		program(other.program), reflection(other.reflection), uniformSlots(other.uniformSlots), uniformNames(other.uniformNames),
+		uniformCount(other.uniformCount), uniformHashCollision(other.uniformHashCollision), uniformCacheStats(other.uniformCacheStats), loadInfo(other.loadInfo),
+		stages(other.stages), separable(other.separable),
+		uniformElements(other.uniformElements), uniformShadow(other.uniformShadow), directStateAccess(other.directStateAccess), uniformUploadStats(other.uniformUploadStats)
+	{
+	}
+
+	/**
+	 * @brief The preprocessed source of a stage.
+	 * 
+	 * The source is a list of strings that point into the mapped source files,
+	 * with generated lines (e.g. #line and #define directives) in between. It is
+	 * handed to glShaderSource as is, so the files are never copied. SPIR-V
+	 * modules consist of a single string holding the entire module.
+	 */
+	struct ShaderStageSource
+	{
+		GLenum type;										///< Type of the stage
+		GLuint shader;										///< Handle to the shader object
+		bool binary;										///< The stage is a SPIR-V module in strings[0]
+		const EmbeddedShaderFile* embeddedFiles;			///< Table the files are taken from, nullptr to read them from disk
+		size_t embeddedFilesSize;							///< Number of entries in embeddedFiles
+		std::vector<GLuint> constantIndices;				///< Specialization constants of a SPIR-V module
+		std::vector<GLuint> constantValues;					///< Values of the specialization constants
+		std::vector<std::string> sourceFiles;				///< Files of the stage, indexed by source string number
+		std::vector<std::unique_ptr<MappedFile>> files;		///< Mappings the strings point into
+		std::vector<std::unique_ptr<std::string>> generated;	///< Generated lines the strings point into
+		std::vector<const GLchar*> strings;					///< Pieces of the source
+		std::vector<GLint> lengths;							///< Length of each piece
+
+		/**
+		 * @brief Adds a piece of a mapped file.
+		 */
+		void Append(const char* data, size_t length)
+		{
+			if (length == 0)
+				return;
+
+			strings.push_back(data);
+			lengths.push_back((GLint)length);
+		}
+
+		/**
+		 * @brief Adds a generated piece.
+		 */
+		void AppendGenerated(std::string&& text)
+		{
+			generated.push_back(std::unique_ptr<std::string>(new std::string(std::move(text))));
+			Append(generated.back()->c_str(), generated.back()->size());
+		}
+
+		/**
+		 * @brief Drops the source after it was handed to OpenGL.
+		 */
+		void ReleaseSource()
+		{
+			strings.clear();
+			lengths.clear();
+			generated.clear();
+			files.clear();
+		}
+	};
+
+	/**
+	 * @brief Get the pipeline stage bit of a shader type.
+	 */
+	static GLbitfield GetStageBit(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_VERTEX_SHADER:			return GL_VERTEX_SHADER_BIT;
+		case GL_TESS_CONTROL_SHADER:	return GL_TESS_CONTROL_SHADER_BIT;
+		case GL_TESS_EVALUATION_SHADER:	return GL_TESS_EVALUATION_SHADER_BIT;
+		case GL_GEOMETRY_SHADER:		return GL_GEOMETRY_SHADER_BIT;
+		case GL_FRAGMENT_SHADER:		return GL_FRAGMENT_SHADER_BIT;
+		case GL_COMPUTE_SHADER:			return GL_COMPUTE_SHADER_BIT;
+		default:						return 0;
+		}
+	}
+
+	/**
+	 * @brief Hashes the type and source of every stage.
+	 */
+	static uint64_t HashStageSources(const std::vector<ShaderStageSource>& stages, uint64_t hash = FNV_OFFSET_BASIS)
+	{
+		const char separator = '\0';
+		for (const ShaderStageSource& stage : stages)
+		{
+			hash = HashBytes(&stage.type, sizeof(stage.type), hash);
+			for (size_t i = 0; i < stage.strings.size(); i++)
+				hash = HashBytes(stage.strings[i], stage.lengths[i], hash);
+
+			hash = HashBytes(stage.constantIndices.data(), stage.constantIndices.size() * sizeof(GLuint), hash);
+			hash = HashBytes(stage.constantValues.data(), stage.constantValues.size() * sizeof(GLuint), hash);
+
+			hash = HashBytes(&separator, sizeof(separator), hash);
+		}
+
+		return hash;
+	}
+
+	/**
+	 * @brief Computes the key of a program in the shader cache.
+	 * 
+	 * The key covers the sources of all stages, wether the program is separable,
+	 * the driver vendor, renderer and version and the supported binary formats.
+	 * 
+	 * @return The cache key, or 0 if the driver does not support program binaries.
+	 */
+	static uint64_t GetProgramCacheKey(const std::vector<ShaderStageSource>& stages, bool separable)
+	{
+		GLint formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		if (formatCount == 0)
+			return 0;
+
+		std::vector<GLint> formats(formatCount);
+		glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+		// The same sources can produce different binaries on a different driver, so the driver is part of the key
+		const char* strings[] = {
+			(const char*)glGetString(GL_VENDOR),
+			(const char*)glGetString(GL_RENDERER),
+			(const char*)glGetString(GL_VERSION)
+		};
+
+		uint64_t hash = HashStageSources(stages);
+		hash = HashBytes(&separable, sizeof(separable), hash);
+		for (const char* string : strings)
+		{
+			if (string != nullptr)
+				hash = HashBytes(string, strlen(string) + 1, hash);
+		}
+
+		return HashBytes(formats.data(), formats.size() * sizeof(GLint), hash);
+	}
+
+	/**
+	 * @brief Tries to create a program from a shader cache entry.
+	 * 
+	 * @param[in] filename Path to the cache entry
+	 * @param[in] key Expected cache key of the entry
+	 * @param[out] rejected Set if the entry existed but the driver rejected it
+	 * 
+	 * @return Handle to the linked program, or 0 on failure.
+	 */
+	static GLuint LoadProgramBinary(const char* filename, uint64_t key, bool& rejected)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.good())
+			return 0;
+
+		ProgramBinaryHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			memcmp(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic)) != 0 || header.key != key)
+		{
+			return 0;
+		}
+
+		std::vector<char> binary(header.length);
+		if (!file.read(binary.data(), binary.size()))
+			return 0;
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+		// Drivers reject binaries after updates, in that case the program is compiled from source again
+		GLint success;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			OGLU_ERROR_STREAM << "Shader cache entry " << filename << " was rejected by the driver, recompiling." << std::endl;
+			glDeleteProgram(program);
+			rejected = true;
+			return 0;
+		}
+
+		return program;
+	}
+
+	/**
+	 * @brief Writes a linked program to the shader cache.
+	 */
+	static void StoreProgramBinary(GLuint program, const char* filename, uint64_t key)
+	{
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length == 0)
+			return;
+
+		ProgramBinaryHeader header;
+		memcpy(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic));
+		header.key = key;
+
+		std::vector<char> binary(length);
+		GLsizei written = 0;
+		glGetProgramBinary(program, length, &written, &header.format, binary.data());
+		header.length = written;
+
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		if (!file.good())
+		{
+			OGLU_ERROR_STREAM << "Failed to write shader cache entry " << filename << std::endl;
+			return;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), written);
+	}
+
+	typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+	bool SupportsParallelShaderCompile()
+	{
+		static int supported = -1;
+		if (supported != -1)
+			return supported;
+
+		PFNGLMAXSHADERCOMPILERTHREADSPROC maxShaderCompilerThreads = nullptr;
+		if (HasExtension("GL_KHR_parallel_shader_compile"))
+			maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSPROC)GetGLProcAddress("glMaxShaderCompilerThreadsKHR");
+		else if (HasExtension("GL_ARB_parallel_shader_compile"))
+			maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSPROC)GetGLProcAddress("glMaxShaderCompilerThreadsARB");
+
+		if (maxShaderCompilerThreads != nullptr)
+			maxShaderCompilerThreads(0xFFFFFFFF);
+
+		supported = (maxShaderCompilerThreads != nullptr);
+		return supported;
+	}
+
+	/**
+	 * @brief Current time in milliseconds, used to time shader creation.
+	 */
+	static double Now()
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * @brief Skips spaces and tabs.
+	 */
+	static const char* SkipBlanks(const char* it, const char* end)
+	{
+		while (it != end && (*it == ' ' || *it == '\t'))
+			it++;
+
+		return it;
+	}
+
+	/**
+	 * @brief Checks if a line is the preprocessor directive @p directive.
+	 * 
+	 * @return Pointer behind the directive name, or nullptr if the line is something else.
+	 */
+	static const char* MatchDirective(const char* line, const char* end, const char* directive)
+	{
+		line = SkipBlanks(line, end);
+		if (line == end || *line != '#')
+			return nullptr;
+
+		line = SkipBlanks(line + 1, end);
+		size_t length = strlen(directive);
+		if ((size_t)(end - line) < length || strncmp(line, directive, length) != 0)
+			return nullptr;
+
+		line += length;
+		if (line != end && *line != ' ' && *line != '\t' && *line != '\r' && *line != '"' && *line != '<')
+			return nullptr;
+
+		return line;
+	}
+
+	/**
+	 * @brief Finds the file referenced by an include directive.
+	 * 
+	 * @param[in] name Name of the included file
+	 * @param[in] includer File containing the directive
+	 * @param[in] quoted True for "name", false for <name>
+	 * 
+	 * @return Path to the file, or an empty path if it doesn't exist.
+	 */
+	static std::filesystem::path ResolveInclude(const std::string& name, const std::filesystem::path& includer, bool quoted)
+	{
+		if (quoted)
+		{
+			std::filesystem::path candidate = includer.parent_path() / name;
+			if (std::filesystem::is_regular_file(candidate))
+				return candidate;
+		}
+
+		for (const std::string& directory : shaderIncludePaths)
+		{
+			std::filesystem::path candidate = std::filesystem::path(directory) / name;
+			if (std::filesystem::is_regular_file(candidate))
+				return candidate;
+		}
+
+		return std::filesystem::path();
+	}
+
+	/**
+	 * @brief Finds a file in the embedded file table of a stage.
+	 * 
+	 * @return The entry, or nullptr if the table has no such file.
+	 */
+	static const EmbeddedShaderFile* FindEmbeddedFile(const ShaderStageSource& stage, const std::filesystem::path& name)
+	{
+		std::string normal = name.lexically_normal().generic_string();
+		for (size_t i = 0; i < stage.embeddedFilesSize; i++)
+		{
+			if (std::filesystem::path(stage.embeddedFiles[i].name).lexically_normal().generic_string() == normal)
+				return &stage.embeddedFiles[i];
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Finds the embedded file referenced by an include directive.
+	 * 
+	 * Works like ResolveInclude(), except that the include paths are replaced by the root of the table.
+	 */
+	static const EmbeddedShaderFile* ResolveEmbeddedInclude(const ShaderStageSource& stage, const std::string& name, const std::filesystem::path& includer, bool quoted)
+	{
+		if (quoted)
+		{
+			const EmbeddedShaderFile* candidate = FindEmbeddedFile(stage, includer.parent_path() / name);
+			if (candidate != nullptr)
+				return candidate;
+		}
+
+		return FindEmbeddedFile(stage, name);
+	}
+
+	/**
+	 * @brief Generates the lines that define every macro in @p defines.
+	 */
+	static std::string GetDefineLines(const ShaderDefine* defines, size_t definesSize)
+	{
+		std::string lines;
+		for (size_t i = 0; i < definesSize; i++)
+			lines += std::string("#define ") + defines[i].name + " " + (defines[i].value ? defines[i].value : "") + "\n";
+
+		return lines;
+	}
+
+	/**
+	 * @brief Resolves the includes of a shader file and injects definitions.
+	 * 
+	 * Every file becomes its own source string number in `#line` directives, so
+	 * compiler messages can be traced back to the file via ShaderStageSource::sourceFiles.
+	 * Lines without directives are referenced in the mapped file and not copied.
+	 * 
+	 * @param[in] filename File to preprocess
+	 * @param[in] data Contents of @p filename, either mapped or embedded, must outlive @p stage
+	 * @param[in] size Size of @p data
+	 * @param[in] defines Definitions to insert after the `#version` directive, only used for the top level file
+	 * @param[in] definesSize Number of definitions
+	 * @param[in] sourceNumber Index of @p filename in ShaderStageSource::sourceFiles
+	 * @param[in] depth How many includes deep @p filename is, 0 for the top level file
+	 * @param[in,out] stage Stage the source is appended to
+	 */
+	static void PreprocessShaderSource(const std::filesystem::path& filename, const char* data, size_t size, const ShaderDefine* defines, size_t definesSize, int sourceNumber, unsigned int depth, ShaderStageSource& stage)
+	{
+		const char* begin = data;
+		const char* end = begin + size;
+
+		bool injectDefines = (depth == 0 && definesSize > 0);
+		if (injectDefines && std::search(begin, end, "#version", "#version" + 8) == end)
+		{
+			// Without a version directive the definitions simply go first
+			stage.AppendGenerated(GetDefineLines(defines, definesSize) + "#line 1 0\n");
+			injectDefines = false;
+		}
+
+		const char* segment = begin;
+		for (int lineNumber = 1; begin != end; lineNumber++)
+		{
+			const char* lineEnd = std::find(begin, end, '\n');
+			const char* next = (lineEnd == end) ? end : lineEnd + 1;
+
+			const char* include = MatchDirective(begin, lineEnd, "include");
+			if (include != nullptr)
+			{
+				include = SkipBlanks(include, lineEnd);
+				char terminator = (include != lineEnd && *include == '<') ? '>' : '"';
+				const char* nameEnd = (include != lineEnd) ? std::find(include + 1, lineEnd, terminator) : lineEnd;
+				if (include == lineEnd || (*include != '"' && *include != '<') || nameEnd == lineEnd)
+					throw std::runtime_error("Malformed #include in " + filename.string() + ":" + std::to_string(lineNumber));
+
+				std::string name(include + 1, nameEnd);
+				const EmbeddedShaderFile* embedded = nullptr;
+				std::filesystem::path path;
+				if (stage.embeddedFiles != nullptr)
+				{
+					embedded = ResolveEmbeddedInclude(stage, name, filename, terminator == '"');
+					if (embedded != nullptr)
+						path = embedded->name;
+				}
+				else
+				{
+					path = ResolveInclude(name, filename, terminator == '"');
+				}
+
+				if (path.empty())
+					throw std::runtime_error("Failed to resolve #include \"" + name + "\" in " + filename.string() + ":" + std::to_string(lineNumber));
+
+				// Conditionals aren't evaluated here, so a file is pasted every time it's included
+				// and has to guard itself. Without a guard a recursive include never ends
+				if (depth >= MAX_INCLUDE_DEPTH)
+					throw std::runtime_error("#include nested too deeply in " + filename.string() + ":" + std::to_string(lineNumber) + ", is an include guard missing?");
+
+				stage.Append(segment, begin - segment);
+				segment = next;
+
+				// A file included again keeps its source string number
+				std::string canonical = embedded ? path.lexically_normal().generic_string() : std::filesystem::weakly_canonical(path).string();
+				int includeNumber = (int)(std::find(stage.sourceFiles.begin(), stage.sourceFiles.end(), canonical) - stage.sourceFiles.begin());
+				if (includeNumber == (int)stage.sourceFiles.size())
+					stage.sourceFiles.push_back(canonical);
+
+				stage.AppendGenerated("#line 1 " + std::to_string(includeNumber) + "\n");
+				if (embedded != nullptr)
+				{
+					PreprocessShaderSource(path, embedded->data, embedded->size, nullptr, 0, includeNumber, depth + 1, stage);
+				}
+				else
+				{
+					stage.files.push_back(std::unique_ptr<MappedFile>(new MappedFile(path.string().c_str())));
+					PreprocessShaderSource(path, stage.files.back()->GetData(), stage.files.back()->GetSize(), nullptr, 0, includeNumber, depth + 1, stage);
+				}
+				stage.AppendGenerated("#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n");
+			}
+			else if (injectDefines && MatchDirective(begin, lineEnd, "version") != nullptr)
+			{
+				stage.Append(segment, next - segment);
+				segment = next;
+
+				stage.AppendGenerated((lineEnd == end ? "\n" : "") + GetDefineLines(defines, definesSize) + "#line " + std::to_string(lineNumber + 1) + " 0\n");
+				injectDefines = false;
+			}
+
+			begin = next;
+		}
+
+		stage.Append(segment, end - segment);
+
+		// The next piece has to start on a new line
+		if (size > 0 && end[-1] != '\n')
+			stage.AppendGenerated("\n");
+	}
+
+	/**
+	 * @brief Get glSpecializeShader, from the 4.6 core or GL_ARB_gl_spirv.
+	 * 
+	 * @return The function, or nullptr if SPIR-V isn't supported.
+	 */
+	static PFNGLSPECIALIZESHADERPROC GetSpecializeShader()
+	{
+		static bool loaded = false;
+		static PFNGLSPECIALIZESHADERPROC specializeShader = nullptr;
+		if (loaded)
+			return specializeShader;
+
+		if (GLAD_GL_VERSION_4_6)
+			specializeShader = glSpecializeShader;
+		else if (HasExtension("GL_ARB_gl_spirv"))
+			specializeShader = (PFNGLSPECIALIZESHADERPROC)GetGLProcAddress("glSpecializeShaderARB");
+
+		loaded = true;
+		return specializeShader;
+	}
+
+	/**
+	 * @brief Maps (or looks up) the top level file of a stage and preprocesses it, or takes it as SPIR-V module.
+	 */
+	static void AddStage(std::vector<ShaderStageSource>& stages, GLenum type, const char* filename, const ShaderFiles& files)
+	{
+		stages.emplace_back();
+		ShaderStageSource& stage = stages.back();
+		stage.type = type;
+		stage.shader = 0;
+		stage.binary = false;
+		stage.embeddedFiles = files.embeddedFiles;
+		stage.embeddedFilesSize = (files.embeddedFiles != nullptr) ? files.embeddedFilesSize / sizeof(EmbeddedShaderFile) : 0;
+		stage.sourceFiles.push_back(filename);
+
+		const char* data;
+		size_t size;
+		if (stage.embeddedFiles != nullptr)
+		{
+			const EmbeddedShaderFile* embedded = FindEmbeddedFile(stage, filename);
+			if (embedded == nullptr)
+				throw std::runtime_error("Shader file is not embedded: " + std::string(filename));
+
+			data = embedded->data;
+			size = embedded->size;
+		}
+		else
+		{
+			stage.files.push_back(std::unique_ptr<MappedFile>(new MappedFile(filename)));
+			data = stage.files.back()->GetData();
+			size = stage.files.back()->GetSize();
+		}
+
+		uint32_t magic = 0;
+		if (size >= sizeof(magic))
+			memcpy(&magic, data, sizeof(magic));
+
+		if (magic != SPIRV_MAGIC)
+		{
+			size_t definesSize = (files.defines != nullptr) ? files.definesSize / sizeof(ShaderDefine) : 0;
+			PreprocessShaderSource(filename, data, size, files.defines, definesSize, 0, 0, stage);
+			return;
+		}
+
+		if (size % sizeof(uint32_t) != 0)
+			throw std::runtime_error("Invalid SPIR-V module: " + std::string(filename));
+
+		if (GetSpecializeShader() == nullptr)
+			throw std::runtime_error("SPIR-V modules require OpenGL 4.6 or GL_ARB_gl_spirv: " + std::string(filename));
+
+		// The module is handed to the driver as it is, straight from the mapping
+		stage.binary = true;
+		stage.Append(data, size);
+
+		size_t specializationsSize = (files.specializations != nullptr) ? files.specializationsSize / sizeof(ShaderSpecialization) : 0;
+		for (size_t i = 0; i < specializationsSize; i++)
+		{
+			stage.constantIndices.push_back(files.specializations[i].index);
+			stage.constantValues.push_back(files.specializations[i].value);
+		}
+	}
+
+	Shader MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile, const ShaderDefine* defines, size_t definesSize)
+	{
+		ShaderFiles files = { vertexShaderFile, fragmentShaderFile, defines, definesSize };
+		return MakeShaders(&files, sizeof(files))[0]->Get();
+	}
+
+	Shader MakeShader(const ShaderStage* stages, size_t stagesSize, const ShaderDefine* defines, size_t definesSize)
+	{
+		ShaderFiles files = { nullptr, nullptr, defines, definesSize, stages, stagesSize };
+		return MakeShaders(&files, sizeof(files))[0]->Get();
+	}
+
+	Shader MakeShader(const ShaderFiles& files)
+	{
+		return MakeShaders(&files, sizeof(files))[0]->Get();
+	}
+
+	Shader MakeShaderFromMemory(const EmbeddedShaderFile* embeddedFiles, size_t embeddedFilesSize, const char* vertexShaderFile, const char* fragmentShaderFile, const ShaderDefine* defines, size_t definesSize)
+	{
+		ShaderFiles files = { vertexShaderFile, fragmentShaderFile, defines, definesSize };
+		files.embeddedFiles = embeddedFiles;
+		files.embeddedFilesSize = embeddedFilesSize;
+		return MakeShaders(&files, sizeof(files))[0]->Get();
+	}
+
+	Shader MakeShaderStage(GLenum type, const char* file, const ShaderDefine* defines, size_t definesSize)
+	{
+		ShaderStage stage = { type, file };
+		ShaderFiles files = { nullptr, nullptr, defines, definesSize, &stage, sizeof(stage), true };
+		return MakeShaders(&files, sizeof(files))[0]->Get();
+	}
+
+	std::vector<PendingShader> MakeShaders(const ShaderFiles* shaders, size_t shadersSize)
+	{
+		shadersSize /= sizeof(ShaderFiles);
+		SupportsParallelShaderCompile();
+
+		std::vector<PendingShader> pending, unique;
+		pending.reserve(shadersSize);
+		for (size_t i = 0; i < shadersSize; i++)
+		{
+			const ShaderFiles& files = shaders[i];
+			size_t stagesSize = (files.stages != nullptr) ? files.stagesSize / sizeof(ShaderStage) : 0;
+
+			std::vector<ShaderStageSource> stages;
+			stages.reserve(stagesSize + 2);
+			if (files.vertexShaderFile != nullptr)
+				AddStage(stages, GL_VERTEX_SHADER, files.vertexShaderFile, files);
+
+			if (files.fragmentShaderFile != nullptr)
+				AddStage(stages, GL_FRAGMENT_SHADER, files.fragmentShaderFile, files);
+
+			for (size_t stage = 0; stage < stagesSize; stage++)
+				AddStage(stages, files.stages[stage].type, files.stages[stage].file, files);
+
+			if (stages.empty())
+				throw std::runtime_error("Shader program has no stages");
+
+			// The preprocessed sources already contain the definitions, and SPIR-V stages carry their constants, so they identify the variant
+			uint64_t variantKey = HashStageSources(stages);
+			variantKey = HashBytes(&files.separable, sizeof(files.separable), variantKey);
+
+			// Requesting the same variant twice in one batch shares the pending program
+			auto duplicate = std::find_if(unique.begin(), unique.end(), [variantKey](const PendingShader& other) { return other->variantKey == variantKey; });
+			if (duplicate != unique.end())
+			{
+				pending.push_back(*duplicate);
+				continue;
+			}
+
+			if (files.separable && !GLAD_GL_VERSION_4_1)
+				throw std::runtime_error("Separable programs require OpenGL 4.1");
+
+			PendingShader shader(new AbstractPendingShader(std::move(stages), variantKey, files.separable));
+			pending.push_back(shader);
+			unique.push_back(shader);
+		}
+
+		// Everything is submitted before the first status query, so the driver never has to finish early
+		for (PendingShader& shader : unique)
+			shader->SubmitCompile();
+
+		for (PendingShader& shader : unique)
+			shader->SubmitLink();
+
+		return pending;
+	}
+
+	AbstractPendingShader::AbstractPendingShader(std::vector<ShaderStageSource>&& stages, uint64_t variantKey, bool separable) :
+		stages(std::move(stages)), variantKey(variantKey), separable(separable), program(0), cacheKey(0), loadInfo{ false, false, 0.0, 0.0 }, startTime(Now())
+	{
+		// Share the program if this variant is already alive
+		auto variant = liveVariants.find(variantKey);
+		if (variant != liveVariants.end())
+		{
+			shader = variant->second.lock();
+			if (shader)
+				return;
+
+			liveVariants.erase(variant);
+		}
+
+		// Only the time spent on this program is counted, not the time until Get() is called
+		double loadStart = Now();
+
+		// SPIR-V already skips the front end, and some drivers crash when asked for the binary of such a program
+		bool spirv = std::any_of(this->stages.begin(), this->stages.end(), [](const ShaderStageSource& stage) { return stage.binary; });
+
+		// Try to skip compilation entirely by loading a previously linked binary
+		if (!shaderCacheDirectory.empty() && !spirv)
+		{
+			cacheKey = GetProgramCacheKey(this->stages, separable);
+			if (cacheKey != 0)
+			{
+				char keyString[17];
+				snprintf(keyString, sizeof(keyString), "%016llx", (unsigned long long)cacheKey);
+				cacheFile = shaderCacheDirectory + "/" + keyString + ".bin";
+
+				program = LoadProgramBinary(cacheFile.c_str(), cacheKey, loadInfo.cacheRejected);
+				loadInfo.fromCache = (program != 0);
+			}
+		}
+
+		loadInfo.milliseconds += Now() - loadStart;
+	}
+
+	AbstractPendingShader::~AbstractPendingShader()
+	{
+		Release();
+	}
+
+	void AbstractPendingShader::SubmitCompile()
+	{
+		double compileStart = Now();
+		for (ShaderStageSource& stage : stages)
+		{
+			if (!shader && !loadInfo.fromCache)
+			{
+				stage.shader = glCreateShader(stage.type);
+				if (stage.binary)
+				{
+					// Specializing a SPIR-V module takes the place of compiling it
+					glShaderBinary(1, &stage.shader, GL_SHADER_BINARY_FORMAT_SPIR_V, stage.strings[0], stage.lengths[0]);
+					GetSpecializeShader()(stage.shader, "main", (GLuint)stage.constantIndices.size(), stage.constantIndices.data(), stage.constantValues.data());
+				}
+				else
+				{
+					glShaderSource(stage.shader, (GLsizei)stage.strings.size(), stage.strings.data(), stage.lengths.data());
+					glCompileShader(stage.shader);
+				}
+			}
+
+			// OpenGL copied the source, the files can be unmapped
+			stage.ReleaseSource();
+		}
+
+		loadInfo.milliseconds += Now() - compileStart;
+	}
+
+	void AbstractPendingShader::SubmitLink()
+	{
+		if (shader || loadInfo.fromCache)
+			return;
+
+		double linkStart = Now();
+		program = glCreateProgram();
+		if (!cacheFile.empty())
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		if (separable)
+			glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+
+		for (const ShaderStageSource& stage : stages)
+			glAttachShader(program, stage.shader);
+
+		glLinkProgram(program);
+		loadInfo.milliseconds += Now() - linkStart;
+	}
+
+	bool AbstractPendingShader::IsReady()
+	{
+		if (shader || !error.empty() || loadInfo.fromCache || !SupportsParallelShaderCompile())
+			return true;
+
+		GLint completed = GL_FALSE;
+		glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+		return completed;
+	}
+
+	Shader AbstractPendingShader::Get()
+	{
+		if (shader)
+			return shader;
+
+		if (!error.empty())
+			throw std::runtime_error(error);
+
+		if (!loadInfo.fromCache)
+		{
+			// Blocks until the driver is done, unless the program finished in the background
+			double queryStart = Now();
+			int success;
+			char infoLog[512];
+			for (const ShaderStageSource& stage : stages)
+			{
+				glGetShaderiv(stage.shader, GL_COMPILE_STATUS, &success);
+				if (!success)
+				{
+					error = GetCompileError(stage);
+					Release();
+					throw std::runtime_error(error);
+				}
+			}
+
+			glGetProgramiv(program, GL_LINK_STATUS, &success);
+			if (!success)
+			{
+				glGetProgramInfoLog(program, 512, NULL, infoLog);
+				error = ("Failed to link program.\n" + std::string(infoLog));
+				Release();
+				throw std::runtime_error(error);
+			}
+
+			loadInfo.milliseconds += Now() - queryStart;
+
+			// Dispose of shader objects
+			for (ShaderStageSource& stage : stages)
+			{
+				glDeleteShader(stage.shader);
+				stage.shader = 0;
+			}
+
+			if (!cacheFile.empty())
+				StoreProgramBinary(program, cacheFile.c_str(), cacheKey);
+		}
+
+		loadInfo.latency = Now() - startTime;
+
+		// Programs with a single compute stage get the dispatch interface
+		if (stages.size() == 1 && stages[0].type == GL_COMPUTE_SHADER)
+			shader = Shader(new AbstractComputeShader(program, loadInfo));
+		else
+			shader = Shader(new AbstractShader(program, loadInfo));
+		for (const ShaderStageSource& stage : stages)
+			shader->stages |= GetStageBit(stage.type);
+
+		// Separable programs are never in use, so uniforms can only be set directly
+		shader->separable = separable;
+		shader->directStateAccess = separable;
+		program = 0;
+
+		liveVariants[variantKey] = shader;
+		return shader;
+	}
+
+	std::string AbstractPendingShader::GetCompileError(const ShaderStageSource& stage)
+	{
+		char infoLog[512];
+		glGetShaderInfoLog(stage.shader, 512, NULL, infoLog);
+
+		std::string message = "Failed to compile shader " + stage.sourceFiles[0] + "\n" + infoLog;
+		if (stage.sourceFiles.size() > 1)
+		{
+			// Messages refer to included files by their source string number
+			message += "Source strings:\n";
+			for (size_t i = 0; i < stage.sourceFiles.size(); i++)
+				message += "  " + std::to_string(i) + ": " + stage.sourceFiles[i] + "\n";
+		}
+
+		return message;
+	}
+
+	void AbstractPendingShader::Release()
+	{
+		for (ShaderStageSource& stage : stages)
+		{
+			glDeleteShader(stage.shader);
+			stage.shader = 0;
+			stage.ReleaseSource();
+		}
+
+		glDeleteProgram(program);
+		program = 0;
+	}
+
+	AbstractShader::AbstractShader(GLuint program, const ShaderLoadInfo& loadInfo) :
+		program(program), reflection(new ShaderReflection(program)), uniformCount(0), uniformHashCollision(false),
+		uniformCacheStats{ 0, 0 }, loadInfo(loadInfo), stages(0), separable(false), uniformShadow(new UniformShadow{ false }), directStateAccess(false), uniformUploadStats{ 0, 0 }
+	{
+		BuildUniformCache();
+	}
+
+	const ShaderLoadInfo& AbstractShader::GetLoadInfo() const
+	{
+		return loadInfo;
+	}
+
+	GLbitfield AbstractShader::GetStages() const
+	{
+		return stages;
+	}
+
+	bool AbstractShader::IsSeparable() const
+	{
+		return separable;
+	}
+
+	const ShaderReflection& AbstractShader::GetReflection() const
+	{
+		return *reflection;
+	}
+
+	void SetShaderCacheDirectory(const char* directory)
+	{
+		if (directory == nullptr)
+		{
+			shaderCacheDirectory.clear();
+			return;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+			throw std::runtime_error("Failed to create shader cache directory " + std::string(directory) + ": " + error.message());
+
+		shaderCacheDirectory = directory;
+	}
+
+	void AddShaderIncludePath(const char* directory)
+	{
+		shaderIncludePaths.push_back(directory);
+	}
+
+	void ClearShaderIncludePaths()
+	{
+		shaderIncludePaths.clear();
+	}
+
+	AbstractShader::~AbstractShader()
+	{
+		StateTracker::Current().OnDeleteProgram(program);
+		glDeleteProgram(program);
+	}
+
+	void AbstractShader::Use()
 	{
+		StateTracker::Current().UseProgram(program);
 	}
 
-	Shader MakeShader(const char* vertexShaderFile, const char* fragmentShaderFile)
+	void AbstractShader::BindUniformBlock(const GLchar* name, GLuint binding)
 	{
-		AbstractShader* tmp = new AbstractShader(vertexShaderFile, fragmentShaderFile);
-		return Shader(tmp);
+		const ShaderBlockInfo* block = reflection->FindUniformBlock(name);
+		if (block == nullptr)
+		{
+			OGLU_ERROR_STREAM << "Failed to locate uniform block \"" << name << "\" in program " << program << "\n";
+			return;
+		}
+
+		glUniformBlockBinding(program, block->index, binding);
 	}
 
-	AbstractShader::AbstractShader(const char* vertexShaderFile, const char* fragmentShaderFile) :
-		program(0)
+	void AbstractShader::BindStorageBlock(const GLchar* name, GLuint binding)
 	{
-		// Load vertex shader
-		char* source = nullptr;
-		LoadShaderSource(vertexShaderFile, &source);
-		
-		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-		glShaderSource(vertexShader, 1, &source, NULL);
-		glCompileShader(vertexShader);
+		const ShaderBlockInfo* block = reflection->FindStorageBlock(name);
+		if (block == nullptr)
+		{
+			OGLU_ERROR_STREAM << "Failed to locate storage block \"" << name << "\" in program " << program << "\n";
+			return;
+		}
 
-		int success;
-		char infoLog[512];
-		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-		if (!success)
+		glShaderStorageBlockBinding(program, block->index, binding);
+	}
+
+	GLint AbstractShader::GetUniformLocation(const GLchar* name)
+	{
+		size_t length;
+		uint64_t hash = HashUniformName(name, length);
+
+		size_t mask = uniformSlots.size() - 1;
+		for (size_t i = hash & mask; uniformSlots[i].nameLength != 0; i = (i + 1) & mask)
+		{
+			const UniformSlot& slot = uniformSlots[i];
+			if (slot.hash == hash && slot.nameLength == length && memcmp(&uniformNames[slot.nameOffset], name, length) == 0)
+			{
+				uniformCacheStats.hits++;
+				return slot.location;
+			}
+		}
+
+		// Not an active uniform name (e.g. a typo or an optimized out uniform), ask the driver once
+		uniformCacheStats.misses++;
+		GLint location = glGetUniformLocation(program, name);
+		InsertUniformLocation(name, length, hash, location);
+		return location;
+	}
+
+	GLint AbstractShader::GetUniformLocation(UniformID id)
+	{
+		size_t mask = uniformSlots.size() - 1;
+		for (size_t i = id.hash & mask; uniformSlots[i].nameLength != 0; i = (i + 1) & mask)
 		{
-			glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-			std::string err = ("Failed to compile shader " + std::string(vertexShaderFile) + "\n" + infoLog);
-			delete source;
-			glDeleteShader(vertexShader);
-			throw std::runtime_error(err);
+			const UniformSlot& slot = uniformSlots[i];
+			if (slot.hash != id.hash)
+				continue;
+
+			// Only programs with colliding names need the name comparison
+			if (!uniformHashCollision || (slot.nameLength == id.length && memcmp(&uniformNames[slot.nameOffset], id.name, id.length) == 0))
+			{
+				uniformCacheStats.hits++;
+				return slot.location;
+			}
 		}
-		delete source;
 
-		// Load Fragment shader
-		LoadShaderSource(fragmentShaderFile, &source);
+		// The name may be a view into a longer string, OpenGL needs it terminated
+		uniformCacheStats.misses++;
+		GLint location = glGetUniformLocation(program, std::string(id.name, id.length).c_str());
+		InsertUniformLocation(id.name, id.length, id.hash, location);
+		return location;
+	}
 
-		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-		glShaderSource(fragmentShader, 1, &source, NULL);
-		glCompileShader(fragmentShader);
+	const UniformCacheStats& AbstractShader::GetUniformCacheStats() const
+	{
+		return uniformCacheStats;
+	}
 
-		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-		if (!success)
+	void AbstractShader::ResetUniformCacheStats()
+	{
+		uniformCacheStats = { 0, 0 };
+	}
+
+	void AbstractShader::BuildUniformCache()
+	{
+		ResizeUniformCache(16);
+
+		std::string name;
+		for (const ShaderUniformInfo& uniform : reflection->GetUniforms())
 		{
-			glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-			std::string err = ("Failed to compile shader " + std::string(fragmentShaderFile) + "\n" + infoLog);
-			delete source;
-			glDeleteShader(vertexShader);
-			glDeleteShader(fragmentShader);
-			throw std::runtime_error(err);
+			name.assign(uniform.name);
+			size_t length = name.size(), hashedLength;
+			InsertUniformLocation(name.c_str(), length, HashUniformName(name.c_str(), hashedLength), uniform.location);
+
+			// Uniforms in blocks have no location
+			if (uniform.location != -1)
+				uniformElements.push_back({ uniform.location, uniform.type, uniform.arraySize });
+
+			// Arrays are reported as "name[0]", make "name" and every other element known as well
+			if (length > 3 && name.compare(length - 3, 3, "[0]") == 0)
+			{
+				size_t baseLength = length - 3;
+				name.resize(baseLength);
+				InsertUniformLocation(name.c_str(), baseLength, HashUniformName(name.c_str(), hashedLength), uniform.location);
+
+				for (GLint element = 1; element < uniform.arraySize; element++)
+				{
+					name.resize(baseLength);
+					name += "[" + std::to_string(element) + "]";
+					GLint elementLocation = glGetUniformLocation(program, name.c_str());
+					InsertUniformLocation(name.c_str(), name.size(), HashUniformName(name.c_str(), hashedLength), elementLocation);
+
+					if (uniform.location != -1)
+						uniformElements.push_back({ elementLocation, uniform.type, uniform.arraySize - element });
+				}
+			}
 		}
-		delete source;
+	}
 
-		// Link into program
-		program = glCreateProgram();
-		glAttachShader(program, vertexShader);
-		glAttachShader(program, fragmentShader);
-		glLinkProgram(program);
+	void AbstractShader::SetUniformShadowing(bool enable)
+	{
+		UniformShadow& shadow = *uniformShadow;
+		if (enable == shadow.enabled)
+			return;
 
-		glGetProgramiv(program, GL_LINK_STATUS, &success);
-		if (!success)
+		shadow.enabled = enable;
+		if (!enable)
 		{
-			glGetProgramInfoLog(program, 512, NULL, infoLog);
-			std::string err = ("Failed to link program.\n" + std::string(infoLog));
-			glDeleteShader(vertexShader);
-			glDeleteShader(fragmentShader);
-			glDeleteProgram(program);
-			throw std::runtime_error(err);
+			shadow.slots.clear();
+			shadow.storage.clear();
+			return;
+		}
+
+		GLint maxLocation = -1;
+		GLuint storageSize = 0;
+		for (const UniformElement& element : uniformElements)
+		{
+			maxLocation = std::max(maxLocation, element.location);
+			storageSize += GetUniformTypeSize(element.type);
 		}
 
-		// Dispose of shader objects
-		glDeleteShader(fragmentShader);
-		glDeleteShader(vertexShader);
+		shadow.slots.assign(maxLocation + 1, ShadowSlot{ 0, 0 });
+		shadow.storage.assign(storageSize, 0);
+
+		// Elements of an array are listed in order, so they end up next to each other in the storage
+		GLuint offset = 0;
+		for (const UniformElement& element : uniformElements)
+		{
+			GLuint elementSize = GetUniformTypeSize(element.type);
+			if (elementSize == 0)
+				continue;
+
+			shadow.slots[element.location] = { offset, elementSize * element.remaining };
+
+			void* values = &shadow.storage[offset];
+			switch (GetUniformComponentType(element.type))
+			{
+			case GL_FLOAT:			glGetUniformfv(program, element.location, static_cast<GLfloat*>(values)); break;
+			case GL_INT:			glGetUniformiv(program, element.location, static_cast<GLint*>(values)); break;
+			case GL_UNSIGNED_INT:	glGetUniformuiv(program, element.location, static_cast<GLuint*>(values)); break;
+			}
+
+			offset += elementSize;
+		}
 	}
 
-	AbstractShader::~AbstractShader()
+	const UniformUploadStats& AbstractShader::GetUniformUploadStats() const
 	{
-		glDeleteProgram(program);
+		return uniformUploadStats;
 	}
 
-	void AbstractShader::Use()
+	void AbstractShader::ResetUniformUploadStats()
 	{
-		glUseProgram(program);
+		uniformUploadStats = { 0, 0 };
 	}
 
-	GLint AbstractShader::GetUniformLocation(const GLchar* name)
+	void AbstractShader::SetDirectStateAccess(bool enable)
+	{
+		// The bundled loader only loads glProgramUniform* as part of the 4.1 core
+		if (enable && !GLAD_GL_VERSION_4_1)
+		{
+			OGLU_ERROR_STREAM << "Direct state access for uniforms requires OpenGL 4.1" << std::endl;
+			return;
+		}
+
+		directStateAccess = enable;
+	}
+
+	bool AbstractShader::GetDirectStateAccess() const
+	{
+		return directStateAccess;
+	}
+
+	inline bool AbstractShader::ShouldUpload(GLint location, const void* data, size_t size)
+	{
+		UniformShadow& shadow = *uniformShadow;
+		if (shadow.enabled && location >= 0 && (size_t)location < shadow.slots.size())
+		{
+			const ShadowSlot& slot = shadow.slots[location];
+
+			// Uploads that don't fit the uniform are errors in OpenGL, let them through unchanged
+			if (size <= slot.size)
+			{
+				unsigned char* values = &shadow.storage[slot.offset];
+				if (memcmp(values, data, size) == 0)
+				{
+					uniformUploadStats.skipped++;
+					return false;
+				}
+
+				memcpy(values, data, size);
+			}
+		}
+
+		uniformUploadStats.issued++;
+		return true;
+	}
+
+	bool AbstractShader::ShouldUploadMatrix(GLint location, GLsizei count, GLboolean transpose, int columns, int rows, const GLfloat* value)
+	{
+		size_t size = (size_t)count * columns * rows * sizeof(GLfloat);
+		if (!transpose)
+			return ShouldUpload(location, value, size);
+
+		// The program stores matrices column major, so compare against the transposed input
+		std::vector<GLfloat> columnMajor((size_t)count * columns * rows);
+		for (GLsizei matrix = 0; matrix < count; matrix++)
+		{
+			const GLfloat* src = value + matrix * columns * rows;
+			GLfloat* dst = columnMajor.data() + matrix * columns * rows;
+			for (int column = 0; column < columns; column++)
+				for (int row = 0; row < rows; row++)
+					dst[column * rows + row] = src[row * columns + column];
+		}
+
+		return ShouldUpload(location, columnMajor.data(), size);
+	}
+
+	void AbstractShader::InsertUniformLocation(const GLchar* name, size_t length, uint64_t hash, GLint location)
+	{
+		// Keep the load factor at or below 0.5 so probe sequences stay short
+		if ((uniformCount + 1) * 2 > uniformSlots.size())
+			ResizeUniformCache(uniformSlots.size() * 2);
+
+		size_t mask = uniformSlots.size() - 1;
+		size_t i = hash & mask;
+		while (uniformSlots[i].nameLength != 0)
+		{
+			const UniformSlot& slot = uniformSlots[i];
+			if (slot.hash == hash)
+			{
+				if (slot.nameLength == length && memcmp(&uniformNames[slot.nameOffset], name, length) == 0)
+					return;
+
+				if (!uniformHashCollision)
+				{
+					OGLU_ERROR_STREAM << "Uniforms \"" << &uniformNames[slot.nameOffset] << "\" and \"" << std::string(name, length)
+						<< "\" share a hash in program " << program << ", UniformID lookups will compare names" << std::endl;
+				}
+
+				uniformHashCollision = true;
+			}
+
+			i = (i + 1) & mask;
+		}
+
+		uniformSlots[i] = { hash, location, (GLuint)uniformNames.size(), (GLuint)length };
+		uniformNames.insert(uniformNames.end(), name, name + length);
+		uniformNames.push_back('\0');
+		uniformCount++;
+	}
+
+	void AbstractShader::ResizeUniformCache(size_t capacity)
 	{
-		return glGetUniformLocation(program, name);
+		std::vector<UniformSlot> oldSlots(capacity, UniformSlot{ 0, -1, 0, 0 });
+		oldSlots.swap(uniformSlots);
+
+		size_t mask = capacity - 1;
+		for (const UniformSlot& slot : oldSlots)
+		{
+			if (slot.nameLength == 0)
+				continue;
+
+			size_t i = slot.hash & mask;
+			while (uniformSlots[i].nameLength != 0)
+				i = (i + 1) & mask;
+
+			uniformSlots[i] = slot;
+		}
 	}
 
 #pragma region Uniforms
 	void AbstractShader::SetUniform(const GLchar* name, GLfloat v0)
 	{
-		glUniform1f(glGetUniformLocation(program, name), v0);
+		SetUniform(GetUniformLocation(name), v0);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLfloat v0)
 	{
-		glUniform1f(location, v0);
+		if (!ShouldUpload(location, &v0, sizeof(v0)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1f(program, location, v0);
+		else
+			glUniform1f(location, v0);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLfloat v0, GLfloat v1)
 	{
-		glUniform2f(glGetUniformLocation(program, name), v0, v1);
+		SetUniform(GetUniformLocation(name), v0, v1);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLfloat v0, GLfloat v1)
 	{
-		glUniform2f(location, v0, v1);
+		GLfloat value[] = { v0, v1 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2f(program, location, v0, v1);
+		else
+			glUniform2f(location, v0, v1);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLfloat v0, GLfloat v1, GLfloat v2)
 	{
-		glUniform3f(glGetUniformLocation(program, name), v0, v1, v2);
+		SetUniform(GetUniformLocation(name), v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
 	{
-		glUniform3f(location, v0, v1, v2);
+		GLfloat value[] = { v0, v1, v2 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3f(program, location, v0, v1, v2);
+		else
+			glUniform3f(location, v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
 	{
-		glUniform4f(glGetUniformLocation(program, name), v0, v1, v2, v3);
+		SetUniform(GetUniformLocation(name), v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
 	{
-		glUniform4f(location, v0, v1, v2, v3);
+		GLfloat value[] = { v0, v1, v2, v3 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4f(program, location, v0, v1, v2, v3);
+		else
+			glUniform4f(location, v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLint v0)
 	{
-		glUniform1i(glGetUniformLocation(program, name), v0);
+		SetUniform(GetUniformLocation(name), v0);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLint v0)
 	{
-		glUniform1i(location, v0);
+		if (!ShouldUpload(location, &v0, sizeof(v0)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1i(program, location, v0);
+		else
+			glUniform1i(location, v0);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLint v0, GLint v1)
 	{
-		glUniform2i(glGetUniformLocation(program, name), v0, v1);
+		SetUniform(GetUniformLocation(name), v0, v1);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLint v0, GLint v1)
 	{
-		glUniform2i(location, v0, v1);
+		GLint value[] = { v0, v1 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2i(program, location, v0, v1);
+		else
+			glUniform2i(location, v0, v1);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLint v0, GLint v1, GLint v2)
 	{
-		glUniform3i(glGetUniformLocation(program, name), v0, v1, v2);
+		SetUniform(GetUniformLocation(name), v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLint v0, GLint v1, GLint v2)
 	{
-		glUniform3i(location, v0, v1, v2);
+		GLint value[] = { v0, v1, v2 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3i(program, location, v0, v1, v2);
+		else
+			glUniform3i(location, v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLint v0, GLint v1, GLint v2, GLint v3)
 	{
-		glUniform4i(glGetUniformLocation(program, name), v0, v1, v2, v3);
+		SetUniform(GetUniformLocation(name), v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
 	{
-		glUniform4i(location, v0, v1, v2, v3);
+		GLint value[] = { v0, v1, v2, v3 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4i(program, location, v0, v1, v2, v3);
+		else
+			glUniform4i(location, v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLuint v0)
 	{
-		glUniform1ui(glGetUniformLocation(program, name), v0);
+		SetUniform(GetUniformLocation(name), v0);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLuint v0)
 	{
-		glUniform1ui(location, v0);
+		if (!ShouldUpload(location, &v0, sizeof(v0)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1ui(program, location, v0);
+		else
+			glUniform1ui(location, v0);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLuint v0, GLuint v1)
 	{
-		glUniform2ui(glGetUniformLocation(program, name), v0, v1);
+		SetUniform(GetUniformLocation(name), v0, v1);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLuint v0, GLuint v1)
 	{
-		glUniform2ui(location, v0, v1);
+		GLuint value[] = { v0, v1 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2ui(program, location, v0, v1);
+		else
+			glUniform2ui(location, v0, v1);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLuint v0, GLuint v1, GLuint v2)
 	{
-		glUniform3ui(glGetUniformLocation(program, name), v0, v1, v2);
+		SetUniform(GetUniformLocation(name), v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLuint v0, GLuint v1, GLuint v2)
 	{
-		glUniform3ui(location, v0, v1, v2);
+		GLuint value[] = { v0, v1, v2 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3ui(program, location, v0, v1, v2);
+		else
+			glUniform3ui(location, v0, v1, v2);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, GLuint v0, GLuint v1, GLuint v2, GLuint v3)
 	{
-		glUniform4ui(glGetUniformLocation(program, name), v0, v1, v2, v3);
+		SetUniform(GetUniformLocation(name), v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3)
 	{
-		glUniform4ui(location, v0, v1, v2, v3);
+		GLuint value[] = { v0, v1, v2, v3 };
+		if (!ShouldUpload(location, value, sizeof(value)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4ui(program, location, v0, v1, v2, v3);
+		else
+			glUniform4ui(location, v0, v1, v2, v3);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, const Color& v0, bool ignoreAlpha)
 	{
-		SetUniform(glGetUniformLocation(program, name), v0, ignoreAlpha);
+		SetUniform(GetUniformLocation(name), v0, ignoreAlpha);
 	}
 
 	void AbstractShader::SetUniform(GLint location, const Color& v0, bool ignoreAlpha)
 	{
 		if (ignoreAlpha)
-			glUniform3f(location, v0.r, v0.g, v0.b);
+			SetUniform(location, v0.r, v0.g, v0.b);
 		else
-			glUniform4f(location, v0.r, v0.g, v0.b, v0.a);
+			SetUniform(location, v0.r, v0.g, v0.b, v0.a);
 	}
 
 	void AbstractShader::SetUniformTexture(const GLchar* name, const Texture& v0, GLbyte index)
 	{
-		SetUniformTexture(glGetUniformLocation(program, name), v0, index);
+		SetUniformTexture(GetUniformLocation(name), v0, index);
 	}
 
 	void AbstractShader::SetUniformTexture(GLint location, const Texture& v0, GLbyte index)
 	{
 		v0->BindAs(index);
-		glUniform1i(location, index);
+		SetUniform(location, (GLint)index);
 	}
 
 	void AbstractShader::SetUniform(const GLchar* name, Transformable& v0, GLboolean transpose)
 	{
-		SetUniform(glGetUniformLocation(program, name), v0);
+		SetUniform(GetUniformLocation(name), v0);
 	}
 
 	void AbstractShader::SetUniform(GLint location, Transformable& v0, GLboolean transpose)
 	{
-		glUniformMatrix4fv(location, 1, transpose, glm::value_ptr(v0.GetMatrix()));
+		SetUniformMatrix4fv(location, 1, transpose, glm::value_ptr(v0.GetMatrix()));
 	}
 
 	void AbstractShader::SetUniform(const GLchar* colorName, const GLchar* intensityName, const AmbientLight& v0)
 	{
 		SetUniform(
-			glGetUniformLocation(program, colorName), 
-			glGetUniformLocation(program, intensityName),
+			GetUniformLocation(colorName), 
+			GetUniformLocation(intensityName),
 			v0
 		);
 	}
@@ -277,228 +1541,518 @@ namespace oglu
 
 	void AbstractShader::SetUniform1fv(const GLchar* name, GLsizei count, const GLfloat* value)
 	{
-		glUniform1fv(glGetUniformLocation(program, name), count, value);
+		SetUniform1fv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform1fv(GLint location, GLsizei count, const GLfloat* value)
 	{
-		glUniform1fv(location, count, value);
+		if (!ShouldUpload(location, value, count * 1 * sizeof(GLfloat)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1fv(program, location, count, value);
+		else
+			glUniform1fv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform2fv(const GLchar* name, GLsizei count, const GLfloat* value)
 	{
-		glUniform2fv(glGetUniformLocation(program, name), count, value);
+		SetUniform2fv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform2fv(GLint location, GLsizei count, const GLfloat* value)
 	{
-		glUniform2fv(location, count, value);
+		if (!ShouldUpload(location, value, count * 2 * sizeof(GLfloat)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2fv(program, location, count, value);
+		else
+			glUniform2fv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform3fv(const GLchar* name, GLsizei count, const GLfloat* value)
 	{
-		glUniform3fv(glGetUniformLocation(program, name), count, value);
+		SetUniform3fv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform3fv(GLint location, GLsizei count, const GLfloat* value)
 	{
-		glUniform3fv(location, count, value);
+		if (!ShouldUpload(location, value, count * 3 * sizeof(GLfloat)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3fv(program, location, count, value);
+		else
+			glUniform3fv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform4fv(const GLchar* name, GLsizei count, const GLfloat* value)
 	{
-		glUniform4fv(glGetUniformLocation(program, name), count, value);
+		SetUniform4fv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform4fv(GLint location, GLsizei count, const GLfloat* value)
 	{
-		glUniform4fv(location, count, value);
+		if (!ShouldUpload(location, value, count * 4 * sizeof(GLfloat)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4fv(program, location, count, value);
+		else
+			glUniform4fv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform1iv(const GLchar* name, GLsizei count, const GLint* value)
 	{
-		glUniform1iv(glGetUniformLocation(program, name), count, value);
+		SetUniform1iv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform1iv(GLint location, GLsizei count, const GLint* value)
 	{
-		glUniform1iv(location, count, value);
+		if (!ShouldUpload(location, value, count * 1 * sizeof(GLint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1iv(program, location, count, value);
+		else
+			glUniform1iv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform2iv(const GLchar* name, GLsizei count, const GLint* value)
 	{
-		glUniform2iv(glGetUniformLocation(program, name), count, value);
+		SetUniform2iv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform2iv(GLint location, GLsizei count, const GLint* value)
 	{
-		glUniform2iv(location, count, value);
+		if (!ShouldUpload(location, value, count * 2 * sizeof(GLint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2iv(program, location, count, value);
+		else
+			glUniform2iv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform3iv(const GLchar* name, GLsizei count, const GLint* value)
 	{
-		glUniform3iv(glGetUniformLocation(program, name), count, value);
+		SetUniform3iv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform3iv(GLint location, GLsizei count, const GLint* value)
 	{
-		glUniform3iv(location, count, value);
+		if (!ShouldUpload(location, value, count * 3 * sizeof(GLint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3iv(program, location, count, value);
+		else
+			glUniform3iv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform4iv(const GLchar* name, GLsizei count, const GLint* value)
 	{
-		glUniform4iv(glGetUniformLocation(program, name), count, value);
+		SetUniform4iv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform4iv(GLint location, GLsizei count, const GLint* value)
 	{
-		glUniform4iv(location, count, value);
+		if (!ShouldUpload(location, value, count * 4 * sizeof(GLint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4iv(program, location, count, value);
+		else
+			glUniform4iv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform1uiv(const GLchar* name, GLsizei count, const GLuint* value)
 	{
-		glUniform1uiv(glGetUniformLocation(program, name), count, value);
+		SetUniform1uiv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform1uiv(GLint location, GLsizei count, const GLuint* value)
 	{
-		glUniform1uiv(location, count, value);
+		if (!ShouldUpload(location, value, count * 1 * sizeof(GLuint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform1uiv(program, location, count, value);
+		else
+			glUniform1uiv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform2uiv(const GLchar* name, GLsizei count, const GLuint* value)
 	{
-		glUniform2uiv(glGetUniformLocation(program, name), count, value);
+		SetUniform2uiv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform2uiv(GLint location, GLsizei count, const GLuint* value)
 	{
-		glUniform2uiv(location, count, value);
+		if (!ShouldUpload(location, value, count * 2 * sizeof(GLuint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform2uiv(program, location, count, value);
+		else
+			glUniform2uiv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform3uiv(const GLchar* name, GLsizei count, const GLuint* value)
 	{
-		glUniform3uiv(glGetUniformLocation(program, name), count, value);
+		SetUniform3uiv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform3uiv(GLint location, GLsizei count, const GLuint* value)
 	{
-		glUniform3uiv(location, count, value);
+		if (!ShouldUpload(location, value, count * 3 * sizeof(GLuint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform3uiv(program, location, count, value);
+		else
+			glUniform3uiv(location, count, value);
 	}
 
 	void AbstractShader::SetUniform4uiv(const GLchar* name, GLsizei count, const GLuint* value)
 	{
-		glUniform4uiv(glGetUniformLocation(program, name), count, value);
+		SetUniform4uiv(GetUniformLocation(name), count, value);
 	}
 
 	void AbstractShader::SetUniform4uiv(GLint location, GLsizei count, const GLuint* value)
 	{
-		glUniform4uiv(location, count, value);
+		if (!ShouldUpload(location, value, count * 4 * sizeof(GLuint)))
+			return;
+
+		if (directStateAccess)
+			glProgramUniform4uiv(program, location, count, value);
+		else
+			glUniform4uiv(location, count, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix2fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 2, 2, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix2fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix2fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix3fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 3, 3, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix3fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix3fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix4fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 4, 4, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix4fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix4fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2x3fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2x3fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix2x3fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2x3fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 2, 3, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix2x3fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix2x3fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3x2fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3x2fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix3x2fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3x2fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 3, 2, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix3x2fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix3x2fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2x4fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2x4fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix2x4fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix2x4fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 2, 4, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix2x4fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix2x4fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4x2fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4x2fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix4x2fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4x2fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 4, 2, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix4x2fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix4x2fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3x4fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3x4fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix3x4fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix3x4fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 3, 4, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix3x4fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix3x4fv(location, count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4x3fv(const GLchar* name, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4x3fv(glGetUniformLocation(program, name), count, transpose, value);
+		SetUniformMatrix4x3fv(GetUniformLocation(name), count, transpose, value);
 	}
 
 	void AbstractShader::SetUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 	{
-		glUniformMatrix4x3fv(location, count, transpose, value);
+		if (!ShouldUploadMatrix(location, count, transpose, 4, 3, value))
+			return;
+
+		if (directStateAccess)
+			glProgramUniformMatrix4x3fv(program, location, count, transpose, value);
+		else
+			glUniformMatrix4x3fv(location, count, transpose, value);
 	}
-#pragma endregion Uniforms
 
-	void AbstractShader::LoadShaderSource(const char* filename, char** buffer)
+	void AbstractShader::SetUniform(UniformID id, GLfloat v0)
 	{
-		std::ifstream file(filename);
-		if (!file.good())
-		{
-			file.close();
-			throw std::runtime_error(std::string("Failed to open shader file: " + std::string(filename)));
-		}
+		SetUniform(GetUniformLocation(id), v0);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLfloat v0, GLfloat v1)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLfloat v0, GLfloat v1, GLfloat v2)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2, v3);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLint v0)
+	{
+		SetUniform(GetUniformLocation(id), v0);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLint v0, GLint v1)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLint v0, GLint v1, GLint v2)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLint v0, GLint v1, GLint v2, GLint v3)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2, v3);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLuint v0)
+	{
+		SetUniform(GetUniformLocation(id), v0);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLuint v0, GLuint v1)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLuint v0, GLuint v1, GLuint v2)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, GLuint v0, GLuint v1, GLuint v2, GLuint v3)
+	{
+		SetUniform(GetUniformLocation(id), v0, v1, v2, v3);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, const Color& v0, bool ignoreAlpha)
+	{
+		SetUniform(GetUniformLocation(id), v0, ignoreAlpha);
+	}
+
+	void AbstractShader::SetUniformTexture(UniformID id, const Texture& v0, GLbyte index)
+	{
+		SetUniformTexture(GetUniformLocation(id), v0, index);
+	}
+
+	void AbstractShader::SetUniform(UniformID id, Transformable& v0, GLboolean transpose)
+	{
+		SetUniform(GetUniformLocation(id), v0, transpose);
+	}
+
+	void AbstractShader::SetUniform1fv(UniformID id, GLsizei count, const GLfloat* value)
+	{
+		SetUniform1fv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform2fv(UniformID id, GLsizei count, const GLfloat* value)
+	{
+		SetUniform2fv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform3fv(UniformID id, GLsizei count, const GLfloat* value)
+	{
+		SetUniform3fv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform4fv(UniformID id, GLsizei count, const GLfloat* value)
+	{
+		SetUniform4fv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform1iv(UniformID id, GLsizei count, const GLint* value)
+	{
+		SetUniform1iv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform2iv(UniformID id, GLsizei count, const GLint* value)
+	{
+		SetUniform2iv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform3iv(UniformID id, GLsizei count, const GLint* value)
+	{
+		SetUniform3iv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform4iv(UniformID id, GLsizei count, const GLint* value)
+	{
+		SetUniform4iv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform1uiv(UniformID id, GLsizei count, const GLuint* value)
+	{
+		SetUniform1uiv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform2uiv(UniformID id, GLsizei count, const GLuint* value)
+	{
+		SetUniform2uiv(GetUniformLocation(id), count, value);
+	}
 
-		// TODO: This is just horrendous
-		std::string str((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-		(*buffer) = (char*)malloc(str.size() + 1);
-		memcpy(*buffer, str.c_str(), str.size());
-		(*buffer)[str.size()] = '\x00';
+	void AbstractShader::SetUniform3uiv(UniformID id, GLsizei count, const GLuint* value)
+	{
+		SetUniform3uiv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniform4uiv(UniformID id, GLsizei count, const GLuint* value)
+	{
+		SetUniform4uiv(GetUniformLocation(id), count, value);
+	}
+
+	void AbstractShader::SetUniformMatrix2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix2fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix3fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix4fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix2x3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix2x3fv(GetUniformLocation(id), count, transpose, value);
 	}
+
+	void AbstractShader::SetUniformMatrix3x2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix3x2fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix2x4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix2x4fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix4x2fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix4x2fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix3x4fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix3x4fv(GetUniformLocation(id), count, transpose, value);
+	}
+
+	void AbstractShader::SetUniformMatrix4x3fv(UniformID id, GLsizei count, GLboolean transpose, const GLfloat* value)
+	{
+		SetUniformMatrix4x3fv(GetUniformLocation(id), count, transpose, value);
+	}
+#pragma endregion Uniforms
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "shaderReflection.hpp"
+
+#include <string>
+#include <cstring>
+
+namespace oglu
+{
+	/**
+	 * @brief Linear search for a named entry, the arrays are short and only searched at load time.
+	 */
+	template<typename Info>
+	static const Info* FindByName(const std::vector<Info>& infos, const GLchar* name)
+	{
+		for (const Info& info : infos)
+		{
+			if (strcmp(info.name, name) == 0)
+				return &info;
+		}
+
+		return nullptr;
+	}
+
+	ShaderReflection::ShaderReflection(GLuint program)
+	{
+		// Names are collected as offsets first and turned into pointers once the pool stopped growing
+		std::vector<size_t> attributeNames, uniformNames, uniformBlockNames, storageBlockNames;
+
+		GLint count = 0, maxNameLength = 0;
+		glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+		glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLength);
+
+		std::string name(maxNameLength + 1, '\0');
+		for (GLint i = 0; i < count; i++)
+		{
+			ShaderAttributeInfo attribute = { nullptr, -1, 0, 0 };
+			GLsizei length = 0;
+			glGetActiveAttrib(program, i, maxNameLength, &length, &attribute.arraySize, &attribute.type, &name[0]);
+			attribute.location = glGetAttribLocation(program, name.c_str());
+
+			attributeNames.push_back(AddName(name.c_str(), length));
+			attributes.push_back(attribute);
+		}
+
+		// Every property of every uniform is fetched with one call per property
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+		if (count > 0)
+		{
+			std::vector<GLuint> indices(count);
+			for (GLint i = 0; i < count; i++)
+				indices[i] = i;
+
+			std::vector<GLint> types(count), sizes(count), blockIndices(count), offsets(count), arrayStrides(count), matrixStrides(count), rowMajor(count);
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_TYPE, types.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_SIZE, sizes.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_BLOCK_INDEX, blockIndices.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_OFFSET, offsets.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data());
+			glGetActiveUniformsiv(program, count, indices.data(), GL_UNIFORM_IS_ROW_MAJOR, rowMajor.data());
+
+			name.assign(maxNameLength + 1, '\0');
+			uniforms.reserve(count);
+			for (GLint i = 0; i < count; i++)
+			{
+				GLsizei length = 0;
+				glGetActiveUniformName(program, i, maxNameLength, &length, &name[0]);
+
+				ShaderUniformInfo uniform;
+				uniform.name = nullptr;
+				uniform.location = (blockIndices[i] == -1) ? glGetUniformLocation(program, name.c_str()) : -1;
+				uniform.type = types[i];
+				uniform.arraySize = sizes[i];
+				uniform.blockIndex = blockIndices[i];
+				uniform.offset = offsets[i];
+				uniform.arrayStride = arrayStrides[i];
+				uniform.matrixStride = matrixStrides[i];
+				uniform.rowMajor = (GLboolean)rowMajor[i];
+
+				uniformNames.push_back(AddName(name.c_str(), length));
+				uniforms.push_back(uniform);
+			}
+		}
+
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+		name.assign(maxNameLength + 1, '\0');
+		for (GLint i = 0; i < count; i++)
+		{
+			ShaderBlockInfo block = { nullptr, (GLuint)i, 0, 0, 0 };
+			glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+			glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+			glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &block.activeMembers);
+
+			GLsizei length = 0;
+			glGetActiveUniformBlockName(program, i, maxNameLength, &length, &name[0]);
+
+			uniformBlockNames.push_back(AddName(name.c_str(), length));
+			uniformBlocks.push_back(block);
+		}
+
+		// Storage blocks can only be queried through the program interface API
+		if (GLAD_GL_VERSION_4_3)
+		{
+			glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &count);
+			glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &maxNameLength);
+			name.assign(maxNameLength + 1, '\0');
+
+			const GLenum properties[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+			for (GLint i = 0; i < count; i++)
+			{
+				GLint values[3] = { 0, 0, 0 };
+				glGetProgramResourceiv(program, GL_SHADER_STORAGE_BLOCK, i, 3, properties, 3, NULL, values);
+
+				GLsizei length = 0;
+				glGetProgramResourceName(program, GL_SHADER_STORAGE_BLOCK, i, maxNameLength, &length, &name[0]);
+
+				storageBlockNames.push_back(AddName(name.c_str(), length));
+				storageBlocks.push_back({ nullptr, (GLuint)i, values[0], values[1], values[2] });
+			}
+		}
+
+		for (size_t i = 0; i < attributes.size(); i++)
+			attributes[i].name = &names[attributeNames[i]];
+
+		for (size_t i = 0; i < uniforms.size(); i++)
+			uniforms[i].name = &names[uniformNames[i]];
+
+		for (size_t i = 0; i < uniformBlocks.size(); i++)
+			uniformBlocks[i].name = &names[uniformBlockNames[i]];
+
+		for (size_t i = 0; i < storageBlocks.size(); i++)
+			storageBlocks[i].name = &names[storageBlockNames[i]];
+	}
+
+	size_t ShaderReflection::AddName(const GLchar* name, GLsizei length)
+	{
+		size_t offset = names.size();
+		names.insert(names.end(), name, name + length);
+		names.push_back('\0');
+
+		return offset;
+	}
+
+	const std::vector<ShaderAttributeInfo>& ShaderReflection::GetAttributes() const
+	{
+		return attributes;
+	}
+
+	const std::vector<ShaderUniformInfo>& ShaderReflection::GetUniforms() const
+	{
+		return uniforms;
+	}
+
+	const std::vector<ShaderBlockInfo>& ShaderReflection::GetUniformBlocks() const
+	{
+		return uniformBlocks;
+	}
+
+	const std::vector<ShaderBlockInfo>& ShaderReflection::GetStorageBlocks() const
+	{
+		return storageBlocks;
+	}
+
+	const ShaderAttributeInfo* ShaderReflection::FindAttribute(const GLchar* name) const
+	{
+		return FindByName(attributes, name);
+	}
+
+	const ShaderUniformInfo* ShaderReflection::FindUniform(const GLchar* name) const
+	{
+		const ShaderUniformInfo* uniform = FindByName(uniforms, name);
+		if (uniform != nullptr)
+			return uniform;
+
+		// Arrays are reported by their first element
+		return FindByName(uniforms, (std::string(name) + "[0]").c_str());
+	}
+
+	const ShaderBlockInfo* ShaderReflection::FindUniformBlock(const GLchar* name) const
+	{
+		return FindByName(uniformBlocks, name);
+	}
+
+	const ShaderBlockInfo* ShaderReflection::FindStorageBlock(const GLchar* name) const
+	{
+		return FindByName(storageBlocks, name);
+	}
+}
@@ -0,0 +1,133 @@
+#include "shaderVariants.hpp"
+
+namespace oglu
+{
+	ShaderVariants MakeShaderVariants(const ShaderFiles& files)
+	{
+		return ShaderVariants(new AbstractShaderVariants(files));
+	}
+
+	AbstractShaderVariants::AbstractShaderVariants(const ShaderFiles& files) :
+		vertexShaderFile(files.vertexShaderFile ? files.vertexShaderFile : ""),
+		fragmentShaderFile(files.fragmentShaderFile ? files.fragmentShaderFile : ""),
+		separable(files.separable), embeddedFiles(files.embeddedFiles), embeddedFilesSize(files.embeddedFilesSize), frame(0)
+	{
+		size_t stagesSize = (files.stages != nullptr) ? files.stagesSize / sizeof(ShaderStage) : 0;
+		for (size_t i = 0; i < stagesSize; i++)
+			stageFiles.push_back(files.stages[i].file);
+
+		// The strings are complete now, so pointers into them stay valid
+		for (size_t i = 0; i < stagesSize; i++)
+			stages.push_back({ files.stages[i].type, stageFiles[i].c_str() });
+
+		size_t definesSize = (files.defines != nullptr) ? files.definesSize / sizeof(ShaderDefine) : 0;
+		for (size_t i = 0; i < definesSize; i++)
+		{
+			defineStrings.push_back(files.defines[i].name);
+			defineStrings.push_back(files.defines[i].value ? files.defines[i].value : "");
+		}
+
+		if (files.specializations != nullptr)
+			specializations.assign(files.specializations, files.specializations + files.specializationsSize / sizeof(ShaderSpecialization));
+
+		std::vector<ShaderDefine> defines;
+		uberShader = MakeShader(GetFiles(defines, nullptr, 0));
+	}
+
+	ShaderFiles AbstractShaderVariants::GetFiles(std::vector<ShaderDefine>& defines, const ShaderDefine* extraDefines, size_t extraDefinesSize) const
+	{
+		defines.clear();
+		for (size_t i = 0; i < defineStrings.size(); i += 2)
+			defines.push_back({ defineStrings[i].c_str(), defineStrings[i + 1].c_str() });
+
+		defines.insert(defines.end(), extraDefines, extraDefines + extraDefinesSize);
+
+		ShaderFiles files = {
+			vertexShaderFile.empty() ? nullptr : vertexShaderFile.c_str(),
+			fragmentShaderFile.empty() ? nullptr : fragmentShaderFile.c_str(),
+			defines.data(), defines.size() * sizeof(ShaderDefine),
+			stages.data(), stages.size() * sizeof(ShaderStage),
+			separable,
+			specializations.data(), specializations.size() * sizeof(ShaderSpecialization),
+			embeddedFiles, embeddedFilesSize
+		};
+
+		return files;
+	}
+
+	Shader AbstractShaderVariants::Get(const ShaderDefine* defines, size_t definesSize)
+	{
+		definesSize = (defines != nullptr) ? definesSize / sizeof(ShaderDefine) : 0;
+
+		std::string key;
+		for (size_t i = 0; i < definesSize; i++)
+			key += std::string(defines[i].name) + "=" + (defines[i].value ? defines[i].value : "") + "\n";
+
+		auto variant = variants.find(key);
+		if (variant != variants.end())
+			return variant->second.shader ? variant->second.shader : uberShader;
+
+		Variant& requested = variants[key];
+		requested.requested = frame;
+		try
+		{
+			// Only submits the compilation, the program is finished in Update()
+			std::vector<ShaderDefine> allDefines;
+			ShaderFiles files = GetFiles(allDefines, defines, definesSize);
+			requested.pending = MakeShaders(&files, sizeof(files))[0];
+		}
+		catch (const std::runtime_error& e)
+		{
+			OGLU_ERROR_STREAM << "Failed to build shader variant, using the uber program instead.\n" << e.what() << std::endl;
+		}
+
+		return uberShader;
+	}
+
+	void AbstractShaderVariants::Update()
+	{
+		frame++;
+
+		// Without parallel compilation finishing a variant waits for the driver, so only one is finished per frame
+		bool parallel = SupportsParallelShaderCompile();
+		for (auto& variant : variants)
+		{
+			Variant& candidate = variant.second;
+			if (!candidate.pending || candidate.requested >= frame)
+				continue;
+
+			if (parallel && !candidate.pending->IsReady())
+				continue;
+
+			try
+			{
+				candidate.shader = candidate.pending->Get();
+			}
+			catch (const std::runtime_error& e)
+			{
+				OGLU_ERROR_STREAM << "Failed to build shader variant, using the uber program instead.\n" << e.what() << std::endl;
+			}
+
+			candidate.pending.reset();
+			if (!parallel)
+				break;
+		}
+	}
+
+	const Shader& AbstractShaderVariants::GetUberShader() const
+	{
+		return uberShader;
+	}
+
+	size_t AbstractShaderVariants::GetPendingCount() const
+	{
+		size_t count = 0;
+		for (const auto& variant : variants)
+		{
+			if (variant.second.pending)
+				count++;
+		}
+
+		return count;
+	}
+}
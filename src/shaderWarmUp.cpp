@@ -0,0 +1,75 @@
+#include "shaderWarmUp.hpp"
+
+#include <chrono>
+
+namespace oglu
+{
+	/**
+	 * @brief Enables or disables a capability.
+	 */
+	static void SetCapability(GLenum capability, bool enable)
+	{
+		if (enable)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+	std::vector<double> WarmUpShaders(const ShaderWarmUp* combinations, size_t combinationsSize)
+	{
+		combinationsSize /= sizeof(ShaderWarmUp);
+		std::vector<double> milliseconds;
+		milliseconds.reserve(combinationsSize);
+
+		GLint previousFramebuffer;
+		GLint previousViewport[4];
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+		glGetIntegerv(GL_VIEWPORT, previousViewport);
+		bool depthTest = glIsEnabled(GL_DEPTH_TEST);
+		bool blend = glIsEnabled(GL_BLEND);
+		bool cullFace = glIsEnabled(GL_CULL_FACE);
+
+		// A tiny target with the attachments a regular framebuffer has, so the generated code matches
+		GLuint framebuffer, renderbuffers[2];
+		glGenFramebuffers(1, &framebuffer);
+		glGenRenderbuffers(2, renderbuffers);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1, 1);
+		glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 1, 1);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+		glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+		glViewport(0, 0, 1, 1);
+
+		for (size_t i = 0; i < combinationsSize; i++)
+		{
+			const ShaderWarmUp& combination = combinations[i];
+			SetCapability(GL_DEPTH_TEST, combination.depthTest);
+			SetCapability(GL_BLEND, combination.blend);
+			SetCapability(GL_CULL_FACE, combination.cullFace);
+
+			auto start = std::chrono::steady_clock::now();
+
+			// Waiting for the draw makes sure the driver finished compiling instead of deferring it
+			combination.shader->Use();
+			combination.vertexArray->BindAndDraw(3);
+			glFinish();
+
+			milliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousFramebuffer);
+		glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+		SetCapability(GL_DEPTH_TEST, depthTest);
+		SetCapability(GL_BLEND, blend);
+		SetCapability(GL_CULL_FACE, cullFace);
+
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(2, renderbuffers);
+
+		return milliseconds;
+	}
+}
@@ -0,0 +1,138 @@
+#include "stateTracker.hpp"
+
+namespace oglu
+{
+	static const GLuint UNKNOWN_BINDING = ~0u;	///< Marks a binding that has to be set on the next call
+
+	static StateTracker defaultTracker;
+	static StateTracker* currentTracker = &defaultTracker;
+
+	StateTracker::StateTracker() :
+		program(UNKNOWN_BINDING), pipeline(UNKNOWN_BINDING), vertexArray(UNKNOWN_BINDING), activeUnit(UNKNOWN_BINDING),
+		unbindAfterDraw(true), stats{ 0, 0 }
+	{
+	}
+
+	StateTracker& StateTracker::Current()
+	{
+		return *currentTracker;
+	}
+
+	void StateTracker::MakeCurrent(StateTracker* tracker)
+	{
+		currentTracker = (tracker != nullptr) ? tracker : &defaultTracker;
+	}
+
+	void StateTracker::Invalidate()
+	{
+		program = pipeline = vertexArray = activeUnit = UNKNOWN_BINDING;
+		textures.assign(textures.size(), UNKNOWN_BINDING);
+	}
+
+	inline bool StateTracker::Changes(GLuint& current, GLuint value)
+	{
+		if (current == value)
+		{
+			stats.elided++;
+			return false;
+		}
+
+		stats.issued++;
+		current = value;
+		return true;
+	}
+
+	void StateTracker::UseProgram(GLuint program)
+	{
+		if (Changes(this->program, program))
+			glUseProgram(program);
+	}
+
+	void StateTracker::BindProgramPipeline(GLuint pipeline)
+	{
+		if (Changes(this->pipeline, pipeline))
+			glBindProgramPipeline(pipeline);
+	}
+
+	void StateTracker::BindVertexArray(GLuint vertexArray)
+	{
+		if (Changes(this->vertexArray, vertexArray))
+			glBindVertexArray(vertexArray);
+	}
+
+	void StateTracker::ActiveTexture(GLuint unit)
+	{
+		if (Changes(activeUnit, unit))
+			glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	void StateTracker::BindTexture(GLenum target, GLuint texture)
+	{
+		if (target != GL_TEXTURE_2D || activeUnit == UNKNOWN_BINDING)
+		{
+			stats.issued++;
+			glBindTexture(target, texture);
+			return;
+		}
+
+		if (activeUnit >= textures.size())
+			textures.resize(activeUnit + 1, UNKNOWN_BINDING);
+
+		if (Changes(textures[activeUnit], texture))
+			glBindTexture(target, texture);
+	}
+
+	void StateTracker::BindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		ActiveTexture(unit);
+		BindTexture(target, texture);
+	}
+
+	void StateTracker::OnDeleteProgram(GLuint program)
+	{
+		// A deleted program stays in use until another one is installed, but its handle may be reused
+		if (this->program == program)
+			this->program = UNKNOWN_BINDING;
+	}
+
+	void StateTracker::OnDeleteProgramPipeline(GLuint pipeline)
+	{
+		if (this->pipeline == pipeline)
+			this->pipeline = 0;
+	}
+
+	void StateTracker::OnDeleteVertexArray(GLuint vertexArray)
+	{
+		if (this->vertexArray == vertexArray)
+			this->vertexArray = 0;
+	}
+
+	void StateTracker::OnDeleteTexture(GLuint texture)
+	{
+		for (GLuint& binding : textures)
+		{
+			if (binding == texture)
+				binding = 0;
+		}
+	}
+
+	void StateTracker::SetUnbindAfterDraw(bool unbind)
+	{
+		unbindAfterDraw = unbind;
+	}
+
+	bool StateTracker::GetUnbindAfterDraw() const
+	{
+		return unbindAfterDraw;
+	}
+
+	const StateTrackerStats& StateTracker::GetStats() const
+	{
+		return stats;
+	}
+
+	void StateTracker::ResetStats()
+	{
+		stats = { 0, 0 };
+	}
+}
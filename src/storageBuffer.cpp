@@ -0,0 +1,113 @@
+#include "storageBuffer.hpp"
+
+#include <algorithm>
+
+namespace oglu
+{
+	AbstractStorageBuffer::AbstractStorageBuffer(const AbstractStorageBuffer& other) :
+		buffer(other.buffer), size(other.size), usage(other.usage)
+	{
+	}
+
+	AbstractStorageBuffer::~AbstractStorageBuffer()
+	{
+		glDeleteBuffers(1, &buffer);
+	}
+
+	StorageBuffer MakeStorageBuffer(GLsizeiptr size, GLenum usage)
+	{
+		if (!GLAD_GL_VERSION_4_3)
+			throw std::runtime_error("Shader storage buffers require OpenGL 4.3");
+
+		return StorageBuffer(new AbstractStorageBuffer(size, usage));
+	}
+
+	AbstractStorageBuffer::AbstractStorageBuffer(GLsizeiptr size, GLenum usage) :
+		buffer(0), size(size), usage(usage)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, usage);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	void AbstractStorageBuffer::Bind()
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	}
+
+	void AbstractStorageBuffer::Unbind()
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	void AbstractStorageBuffer::BindBase(GLuint index)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+	}
+
+	void AbstractStorageBuffer::BindRange(GLuint index, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, buffer, offset, size);
+	}
+
+	void AbstractStorageBuffer::Resize(GLsizeiptr size, bool preserve)
+	{
+		GLsizeiptr kept = preserve ? std::min(this->size, size) : 0;
+		if (kept == 0)
+		{
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, usage);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+			this->size = size;
+			return;
+		}
+
+		// Reallocating the storage discards it, so the contents are parked in a temporary buffer
+		GLuint temporary;
+		glGenBuffers(1, &temporary);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, temporary);
+		glBufferData(GL_COPY_WRITE_BUFFER, kept, nullptr, GL_STREAM_COPY);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, kept);
+
+		glBufferData(GL_COPY_READ_BUFFER, size, nullptr, usage);
+		glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER, 0, 0, kept);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &temporary);
+
+		this->size = size;
+	}
+
+	void AbstractStorageBuffer::SetData(const void* data, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	void AbstractStorageBuffer::Upload(const void* data, GLsizeiptr size)
+	{
+		if (size > this->size)
+			this->size = size;
+
+		// Orphan the old storage, then fill the new one
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, this->size, nullptr, usage);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	GLsizeiptr AbstractStorageBuffer::GetSize() const
+	{
+		return size;
+	}
+
+	GLuint AbstractStorageBuffer::GetHandle() const
+	{
+		return buffer;
+	}
+}
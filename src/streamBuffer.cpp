@@ -0,0 +1,120 @@
+#include "streamBuffer.hpp"
+
+namespace oglu
+{
+	static const GLbitfield STREAM_BUFFER_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	StreamBuffer MakeStreamBuffer(GLsizeiptr frameSize, unsigned int frameCount)
+	{
+		if (!GLAD_GL_VERSION_4_4)
+			throw std::runtime_error("Stream buffers require OpenGL 4.4");
+
+		if (frameSize <= 0 || frameCount == 0)
+			throw std::runtime_error("Stream buffers require at least one region that isn't empty");
+
+		return StreamBuffer(new AbstractStreamBuffer(frameSize, frameCount));
+	}
+
+	AbstractStreamBuffer::AbstractStreamBuffer(GLsizeiptr frameSize, unsigned int frameCount) :
+		mapping(nullptr), frameSize(frameSize), fences(frameCount, nullptr), frame(frameCount - 1), frameOffset(0), inFrame(false), stalls(0)
+	{
+		buffer = MakeBufferStorage(frameSize * frameCount, nullptr, STREAM_BUFFER_FLAGS);
+
+		buffer->Bind(GL_COPY_WRITE_BUFFER);
+		mapping = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, buffer->GetSize(), STREAM_BUFFER_FLAGS));
+		buffer->Unbind(GL_COPY_WRITE_BUFFER);
+
+		if (mapping == nullptr)
+			throw std::runtime_error("Failed to map stream buffer");
+	}
+
+	AbstractStreamBuffer::~AbstractStreamBuffer()
+	{
+		for (GLsync fence : fences)
+		{
+			if (fence != nullptr)
+				glDeleteSync(fence);
+		}
+
+		// VAOs may still reference the buffer, they keep it alive without the mapping
+		buffer->Bind(GL_COPY_WRITE_BUFFER);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		buffer->Unbind(GL_COPY_WRITE_BUFFER);
+	}
+
+	void AbstractStreamBuffer::BeginFrame()
+	{
+		if (inFrame)
+			EndFrame();
+
+		frame = (frame + 1) % fences.size();
+		frameOffset = 0;
+		inFrame = true;
+
+		GLsync& fence = fences[frame];
+		if (fence == nullptr)
+			return;
+
+		// Only wait if the GPU is still reading the frame that last used this region
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			stalls++;
+			do
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+
+		if (result == GL_WAIT_FAILED)
+			throw std::runtime_error("Failed to wait for the region of a stream buffer");
+	}
+
+	void AbstractStreamBuffer::EndFrame()
+	{
+		if (!inFrame)
+			return;
+
+		fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		inFrame = false;
+	}
+
+	void* AbstractStreamBuffer::Allocate(GLsizeiptr size, GLintptr& offset, GLsizeiptr alignment)
+	{
+		if (!inFrame)
+			throw std::runtime_error("Stream buffer memory can only be allocated between BeginFrame() and EndFrame()");
+
+		// The offset is aligned within the whole buffer, so it works as a base vertex or binding offset
+		GLintptr regionStart = frame * frameSize;
+		GLintptr start = (regionStart + frameOffset + alignment - 1) / alignment * alignment;
+		if (start + size > regionStart + frameSize)
+			throw std::runtime_error("Stream buffer region is full, " + std::to_string(size) + " bytes requested");
+
+		offset = start;
+		frameOffset = start + size - regionStart;
+		return mapping + start;
+	}
+
+	void AbstractStreamBuffer::BindRange(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBufferRange(target, index, buffer->GetHandle(), offset, size);
+	}
+
+	const Buffer& AbstractStreamBuffer::GetBuffer() const
+	{
+		return buffer;
+	}
+
+	GLsizeiptr AbstractStreamBuffer::GetFrameSize() const
+	{
+		return frameSize;
+	}
+
+	size_t AbstractStreamBuffer::GetStallCount() const
+	{
+		return stalls;
+	}
+}
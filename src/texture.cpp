@@ -1,4 +1,5 @@
 #include "texture.hpp"
+#include "stateTracker.hpp"
 #include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -9,7 +10,7 @@ namespace oglu
 {
 	void ActiveTexture(GLubyte index)
 	{
-		glActiveTexture(GL_TEXTURE0 + index);
+		StateTracker::Current().ActiveTexture(index);
 	}
 
 	AbstractTexture::AbstractTexture(const AbstractTexture& other) :
@@ -19,7 +20,8 @@ namespace oglu
 
 	AbstractTexture::~AbstractTexture()
 	{
-		glDeleteBuffers(1, &texture);
+		StateTracker::Current().OnDeleteTexture(texture);
+		glDeleteTextures(1, &texture);
 	}
 
 	AbstractTexture::AbstractTexture(const char* filename)
@@ -33,7 +35,7 @@ namespace oglu
 		}
 
 		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
+		StateTracker::Current().BindTexture(GL_TEXTURE_2D, texture);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -64,17 +66,16 @@ namespace oglu
 
 	void AbstractTexture::Bind()
 	{
-		glBindTexture(GL_TEXTURE_2D, texture);
+		StateTracker::Current().BindTexture(GL_TEXTURE_2D, texture);
 	}
 
 	void AbstractTexture::BindAs(GLbyte index)
 	{
-		glActiveTexture(GL_TEXTURE0 + index);
-		glBindTexture(GL_TEXTURE_2D, texture);
+		StateTracker::Current().BindTexture(index, GL_TEXTURE_2D, texture);
 	}
 
 	void AbstractTexture::Unbind()
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		StateTracker::Current().BindTexture(GL_TEXTURE_2D, 0);
 	}
 }
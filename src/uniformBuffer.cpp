@@ -0,0 +1,60 @@
+#include "uniformBuffer.hpp"
+
+namespace oglu
+{
+	AbstractUniformBuffer::AbstractUniformBuffer(const AbstractUniformBuffer& other) :
+		buffer(other.buffer), size(other.size)
+	{
+	}
+
+	AbstractUniformBuffer::~AbstractUniformBuffer()
+	{
+		glDeleteBuffers(1, &buffer);
+	}
+
+	UniformBuffer MakeUniformBuffer(GLsizeiptr size, GLenum usage)
+	{
+		return UniformBuffer(new AbstractUniformBuffer(size, usage));
+	}
+
+	AbstractUniformBuffer::AbstractUniformBuffer(GLsizeiptr size, GLenum usage) :
+		buffer(0), size(size)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, size, nullptr, usage);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void AbstractUniformBuffer::Bind()
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	}
+
+	void AbstractUniformBuffer::Unbind()
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void AbstractUniformBuffer::BindBase(GLuint index)
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+	}
+
+	void AbstractUniformBuffer::BindRange(GLuint index, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+	}
+
+	void AbstractUniformBuffer::SetData(const void* data, GLintptr offset, GLsizeiptr size)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	GLsizeiptr AbstractUniformBuffer::GetSize() const
+	{
+		return size;
+	}
+}
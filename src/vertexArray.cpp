@@ -1,150 +1,266 @@
 #include "vertexArray.hpp"
+#include "stateTracker.hpp"
+#include "mesh.hpp"
+#include "meshCache.hpp"
 
-#include <fstream>
-#include <string>
-#include <sstream>
-#include <vector>
+#include <algorithm>
 
 namespace oglu
 {
 	AbstractVertexArray::AbstractVertexArray(const AbstractVertexArray& other) :
-		VAO(other.VAO), VBO(other.VBO), EBO(other.EBO), count(other.count), useIndices(other.useIndices)
+		VAO(other.VAO), vertexBuffer(other.vertexBuffer), indexBuffer(other.indexBuffer), sharedStorage(other.sharedStorage),
+		baseVertex(other.baseVertex), firstIndex(other.firstIndex), count(other.count), indexType(other.indexType), useIndices(other.useIndices)
 	{
 	}
 
 	AbstractVertexArray::~AbstractVertexArray()
 	{
-		glBindVertexArray(0);
+		// VAOs of a mesh pool are deleted by the pool
+		if (sharedStorage)
+			return;
+
+		StateTracker::Current().OnDeleteVertexArray(VAO);
 		glDeleteVertexArrays(1, &VAO);
-		glDeleteBuffers(1, &VBO);
-		glDeleteBuffers(1, &EBO);
 	}
 
 	VertexArray MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLuint* indices, size_t indicesSize, const VertexAttribute* topology, size_t topologySize)
 	{
-		AbstractVertexArray* obj = new AbstractVertexArray(vertices, verticesSize, indices, indicesSize, topology, topologySize);
+		return MakeVertexArray(vertices, verticesSize, indices, indicesSize, GL_UNSIGNED_INT, topology, topologySize);
+	}
+
+	VertexArray MakeVertexArray(const GLfloat* vertices, size_t verticesSize, const GLvoid* indices, size_t indicesSize, GLenum indexType, const VertexAttribute* topology, size_t topologySize)
+	{
+		AbstractVertexArray* obj = new AbstractVertexArray(vertices, verticesSize, indices, indicesSize, indexType, topology, topologySize);
 		return VertexArray(obj);
 	}
 
-	std::shared_ptr<AbstractVertexArray> MakeVertexArray(const char* filepath)
+	VertexArray MakeVertexArray(const char* filepath)
 	{
-		// This sucks
-		std::ifstream file(filepath);
-		if (!file.good())
+		// Models that were loaded before are mapped from the mesh cache instead of being parsed
+		std::string cacheFile = GetMeshCacheFile(filepath);
+		if (!cacheFile.empty())
 		{
-			file.close();
-			throw std::runtime_error("Missing file: " + std::string(filepath));
+			VertexArray cached = MakeVertexArrayFromCache(cacheFile.c_str(), filepath);
+			if (cached)
+				return cached;
 		}
 
-		std::vector<GLfloat> vertices;
-		std::vector<GLuint> indices;
-		
-		std::string line;
-		while(!file.eof())
-		{
-			std::getline(file, line);
-			switch (line[0])
-			{
-			case 'v':
-			{
-				GLfloat x, y, z;
-				int shut_up_vs = sscanf(line.c_str(), "v %f %f %f", &x, &y, &z);
-				vertices.push_back(x);
-				vertices.push_back(y);
-				vertices.push_back(z);
-			} break;
-
-			case 'f':
-			{
-				GLuint a, b, c;
-				int shut_up_vs = sscanf(line.c_str(), "f %u %u %u", &a, &b, &c);
-				indices.push_back(a - 1);
-				indices.push_back(b - 1);
-				indices.push_back(c - 1);
-			} break;
-
-			default: break;
-			}
-		}
+		MeshData mesh = LoadObj(filepath);
+		if (!cacheFile.empty())
+			WriteMeshCache(cacheFile.c_str(), mesh, filepath);
 
-		VertexAttribute topology[] = {
-			{0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0 },
-		};
+		return MakeVertexArray(mesh);
+	}
+
+	VertexArray MakeVertexArray(const Buffer& vertexBuffer, const Buffer& indexBuffer, const VertexAttribute* topology, size_t topologySize, GLint baseVertex, GLsizei firstIndex, GLsizei count, GLenum indexType)
+	{
+		// Rejects invalid types now rather than with a GL error on the first draw
+		if (indexBuffer)
+			AbstractVertexArray::GetIndexSize(indexType);
 
-		return MakeVertexArray(vertices.data(), sizeof(GLfloat) * vertices.size(),
-			indices.data(), sizeof(GLuint) * indices.size(),
-			topology, sizeof(topology)
-		);
+		GLuint VAO = AbstractVertexArray::SetupVertexArray(vertexBuffer, indexBuffer, topology, topologySize);
+		return VertexArray(new AbstractVertexArray(VAO, vertexBuffer, indexBuffer, baseVertex, firstIndex, count, indexType, nullptr));
 	}
 
 	AbstractVertexArray::AbstractVertexArray(const GLfloat* vertices, size_t verticesSize, 
-					const GLuint* indices, size_t indicesSize, 
+					const GLvoid* indices, size_t indicesSize, GLenum indexType,
 					const VertexAttribute* topology, size_t topologySize) :
-		VAO(0), VBO(0), EBO(0), count(0)
+		VAO(0), baseVertex(0), firstIndex(0), count(0), indexType(GL_NONE)
 	{
 		useIndices = (indices != nullptr);
 
-		topologySize /= sizeof(VertexAttribute);
+		vertexBuffer = MakeBuffer(verticesSize, vertices);
+		if (useIndices)
+		{
+			size_t indexCount = indicesSize / GetIndexSize(indexType);
 
-		glGenBuffers(1, &VBO);
-		if(useIndices)
-			glGenBuffers(1, &EBO);
+			// Most meshes have less than 65536 vertices, their indices only need half the memory and bandwidth
+			this->indexType = (GetMaxIndex(indices, indexCount, indexType) <= 0xFFFF) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 
-		glGenVertexArrays(1, &VAO);
-		glBindVertexArray(VAO);
+			std::vector<unsigned char> storage;
+			const GLvoid* data = ConvertIndices(indices, indexCount, indexType, this->indexType, storage);
+			indexBuffer = MakeBuffer(indexCount * GetIndexSize(this->indexType), data);
+			count = (GLsizei)indexCount;
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, verticesSize, vertices, GL_STATIC_DRAW);
+		VAO = SetupVertexArray(vertexBuffer, indexBuffer, topology, topologySize);
 
-		if (useIndices)
+		if (!useIndices)
 		{
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices, GL_STATIC_DRAW);
+			count = (GLsizei)(verticesSize / sizeof(GLfloat)) / (topology[0].stride / sizeof(GLfloat));
 		}
+	}
+
+	AbstractVertexArray::AbstractVertexArray(GLuint VAO, const Buffer& vertexBuffer, const Buffer& indexBuffer, GLint baseVertex, GLsizei firstIndex, GLsizei count, GLenum indexType, const std::shared_ptr<void>& sharedStorage) :
+		VAO(VAO), vertexBuffer(vertexBuffer), indexBuffer(indexBuffer), sharedStorage(sharedStorage),
+		baseVertex(baseVertex), firstIndex(firstIndex), count(count), indexType((indexBuffer != nullptr) ? indexType : GL_NONE), useIndices(indexBuffer != nullptr)
+	{
+	}
+
+	GLuint AbstractVertexArray::SetupVertexArray(const Buffer& vertexBuffer, const Buffer& indexBuffer, const VertexAttribute* topology, size_t topologySize)
+	{
+		topologySize /= sizeof(VertexAttribute);
+
+		GLuint VAO;
+		glGenVertexArrays(1, &VAO);
+		StateTracker::Current().BindVertexArray(VAO);
+
+		vertexBuffer->Bind(GL_ARRAY_BUFFER);
+
+		// The element buffer binding is part of the VAO state
+		if (indexBuffer)
+			indexBuffer->Bind(GL_ELEMENT_ARRAY_BUFFER);
 
 		for (int i = 0; i < topologySize; i++)
 		{
 			RegisterVertexAttribPointer(i, topology[i]);
 		}
 
-		glBindVertexArray(0);
+		StateTracker::Current().BindVertexArray(0);
+		vertexBuffer->Unbind(GL_ARRAY_BUFFER);
 
-		if (useIndices)
-			count = (GLsizei)(indicesSize / sizeof(GLuint));
-		else
-		{
-			count = (GLsizei)(verticesSize / sizeof(GLfloat)) / (topology[0].stride / sizeof(GLfloat));
-		}
+		return VAO;
 	}
 
 	void AbstractVertexArray::Bind()
 	{
-		glBindVertexArray(VAO);
+		StateTracker::Current().BindVertexArray(VAO);
 	}
 
 	void AbstractVertexArray::Unbind()
 	{
-		glBindVertexArray(0);
+		StateTracker::Current().BindVertexArray(0);
 	}
 
 	void AbstractVertexArray::Draw()
 	{
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (GLvoid*)0);
+		DrawRange(count);
 	}
 
 	void AbstractVertexArray::BindAndDraw()
 	{
-		glBindVertexArray(VAO);
+		BindAndDraw(count);
+	}
+
+	void AbstractVertexArray::BindAndDraw(GLsizei count)
+	{
+		count = std::min(count, this->count);
+
+		StateTracker& tracker = StateTracker::Current();
+		tracker.BindVertexArray(VAO);
+		DrawRange(count);
+		
+		if (tracker.GetUnbindAfterDraw())
+			tracker.BindVertexArray(0);
+	}
+
+	void AbstractVertexArray::DrawRange(GLsizei count)
+	{
 		if (useIndices)
 		{
-			glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (GLvoid*)0);
+			// The indices are relative to the first vertex of the range, so packed meshes keep their own indices
+			glDrawElementsBaseVertex(GL_TRIANGLES, count, indexType, (GLvoid*)(firstIndex * GetIndexSize(indexType)), baseVertex);
 		}
 		else
 		{
-			glDrawArrays(GL_TRIANGLES, 0, count);
+			glDrawArrays(GL_TRIANGLES, baseVertex, count);
 		}
-		
-		glBindVertexArray(0);
+	}
+
+	void AbstractVertexArray::SetRange(GLint baseVertex, GLsizei firstIndex, GLsizei count)
+	{
+		this->baseVertex = baseVertex;
+		this->firstIndex = firstIndex;
+		this->count = count;
+	}
+
+	GLenum AbstractVertexArray::GetIndexType() const
+	{
+		return indexType;
+	}
+
+	size_t AbstractVertexArray::GetIndexSize(GLenum indexType)
+	{
+		switch (indexType)
+		{
+		case GL_UNSIGNED_BYTE:	return sizeof(GLubyte);
+		case GL_UNSIGNED_SHORT:	return sizeof(GLushort);
+		case GL_UNSIGNED_INT:	return sizeof(GLuint);
+		}
+
+		throw std::runtime_error("Invalid index type: " + std::to_string(indexType));
+	}
+
+	/**
+	 * @brief Reads the index at @p i of an array of any index type.
+	 */
+	static GLuint ReadIndex(const GLvoid* indices, size_t i, GLenum indexType)
+	{
+		switch (indexType)
+		{
+		case GL_UNSIGNED_BYTE:	return static_cast<const GLubyte*>(indices)[i];
+		case GL_UNSIGNED_SHORT:	return static_cast<const GLushort*>(indices)[i];
+		default:				return static_cast<const GLuint*>(indices)[i];
+		}
+	}
+
+	GLuint AbstractVertexArray::GetMaxIndex(const GLvoid* indices, size_t count, GLenum indexType)
+	{
+		GLuint maxIndex = 0;
+		for (size_t i = 0; i < count; i++)
+			maxIndex = std::max(maxIndex, ReadIndex(indices, i, indexType));
+
+		return maxIndex;
+	}
+
+	const GLvoid* AbstractVertexArray::ConvertIndices(const GLvoid* indices, size_t count, GLenum indexType, GLenum targetType, std::vector<unsigned char>& storage)
+	{
+		if (indexType == targetType)
+			return indices;
+
+		storage.resize(count * GetIndexSize(targetType));
+		for (size_t i = 0; i < count; i++)
+		{
+			GLuint index = ReadIndex(indices, i, indexType);
+			switch (targetType)
+			{
+			case GL_UNSIGNED_BYTE:	reinterpret_cast<GLubyte*>(storage.data())[i] = (GLubyte)index; break;
+			case GL_UNSIGNED_SHORT:	reinterpret_cast<GLushort*>(storage.data())[i] = (GLushort)index; break;
+			default:				reinterpret_cast<GLuint*>(storage.data())[i] = index; break;
+			}
+		}
+
+		return storage.data();
+	}
+
+	size_t GetVertexAttributeSize(const VertexAttribute& attribute)
+	{
+		switch (attribute.type)
+		{
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return attribute.size;
+
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			return attribute.size * 2;
+
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT:
+			return attribute.size * 4;
+
+		case GL_DOUBLE:
+			return attribute.size * 8;
+
+		case GL_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_2_10_10_10_REV:
+		case GL_UNSIGNED_INT_10F_11F_11F_REV:
+			return 4;
+		}
+
+		return 0;
 	}
 
 	void AbstractVertexArray::RegisterVertexAttribPointer(GLuint index, const VertexAttribute& topology)
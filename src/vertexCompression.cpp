@@ -0,0 +1,286 @@
+#include "vertexCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+namespace oglu
+{
+	/**
+	 * @brief Stores floats as GL_HALF_FLOAT.
+	 */
+	class HalfFloatEncoder : public AbstractVertexEncoder
+	{
+	public:
+		void GetFormat(GLint components, GLint& size, GLenum& type, GLboolean& normalized) const override
+		{
+			if (components < 1 || components > 4)
+				throw std::runtime_error("Half float encoding requires 1 to 4 components");
+
+			size = components;
+			type = GL_HALF_FLOAT;
+			normalized = GL_FALSE;
+		}
+
+		size_t GetEncodedSize(GLint components) const override
+		{
+			return components * sizeof(glm::uint16);
+		}
+
+		void Encode(const GLfloat* input, GLint components, void* output) const override
+		{
+			glm::uint16* values = static_cast<glm::uint16*>(output);
+			for (GLint i = 0; i < components; i++)
+				values[i] = glm::packHalf1x16(input[i]);
+		}
+
+		void Decode(const void* input, GLint components, GLfloat* output) const override
+		{
+			const glm::uint16* values = static_cast<const glm::uint16*>(input);
+			for (GLint i = 0; i < components; i++)
+				output[i] = glm::unpackHalf1x16(values[i]);
+		}
+	};
+
+	/**
+	 * @brief Stores unit vectors as two signed normalized octahedral coordinates.
+	 */
+	class OctahedralEncoder : public AbstractVertexEncoder
+	{
+	public:
+		OctahedralEncoder(GLenum type) :
+			type(type)
+		{
+		}
+
+		void GetFormat(GLint components, GLint& size, GLenum& type, GLboolean& normalized) const override
+		{
+			if (components != 3)
+				throw std::runtime_error("Octahedral encoding requires 3 components");
+
+			// Packed types always have 4 elements, the last two stay 0
+			size = (this->type == GL_INT_2_10_10_10_REV) ? 4 : 2;
+			type = this->type;
+			normalized = GL_TRUE;
+		}
+
+		size_t GetEncodedSize(GLint /*components*/) const override
+		{
+			return 4;
+		}
+
+		void Encode(const GLfloat* input, GLint /*components*/, void* output) const override
+		{
+			float length = std::abs(input[0]) + std::abs(input[1]) + std::abs(input[2]);
+			float x = (length > 0.0f) ? input[0] / length : 0.0f;
+			float y = (length > 0.0f) ? input[1] / length : 0.0f;
+
+			// The lower half of the octahedron is folded over the diagonals
+			if (length > 0.0f && input[2] < 0.0f)
+			{
+				float foldedX = (1.0f - std::abs(y)) * ((x >= 0.0f) ? 1.0f : -1.0f);
+				float foldedY = (1.0f - std::abs(x)) * ((y >= 0.0f) ? 1.0f : -1.0f);
+				x = foldedX;
+				y = foldedY;
+			}
+
+			if (type == GL_INT_2_10_10_10_REV)
+			{
+				GLuint packed = (GLuint)(Quantize(x, 511.0f) & 0x3FF) | ((GLuint)(Quantize(y, 511.0f) & 0x3FF) << 10);
+				memcpy(output, &packed, sizeof(packed));
+			}
+			else
+			{
+				GLshort packed[2] = { (GLshort)Quantize(x, 32767.0f), (GLshort)Quantize(y, 32767.0f) };
+				memcpy(output, packed, sizeof(packed));
+			}
+		}
+
+		void Decode(const void* input, GLint /*components*/, GLfloat* output) const override
+		{
+			float x, y;
+			if (type == GL_INT_2_10_10_10_REV)
+			{
+				GLuint packed;
+				memcpy(&packed, input, sizeof(packed));
+
+				// Shifting up and back down sign extends the 10 bit values
+				x = Dequantize((GLint)(packed << 22) >> 22, 511.0f);
+				y = Dequantize((GLint)(packed << 12) >> 22, 511.0f);
+			}
+			else
+			{
+				GLshort packed[2];
+				memcpy(packed, input, sizeof(packed));
+				x = Dequantize(packed[0], 32767.0f);
+				y = Dequantize(packed[1], 32767.0f);
+			}
+
+			float z = 1.0f - std::abs(x) - std::abs(y);
+			float t = std::max(-z, 0.0f);
+			x += (x >= 0.0f) ? -t : t;
+			y += (y >= 0.0f) ? -t : t;
+
+			float length = std::sqrt(x * x + y * y + z * z);
+			output[0] = x / length;
+			output[1] = y / length;
+			output[2] = z / length;
+		}
+
+	private:
+		/**
+		 * @brief Converts a value between -1 and 1 to a signed normalized integer.
+		 */
+		static GLint Quantize(float value, float scale)
+		{
+			return (GLint)std::round(std::min(std::max(value, -1.0f), 1.0f) * scale);
+		}
+
+		/**
+		 * @brief Converts a signed normalized integer back, like the GPU does.
+		 */
+		static float Dequantize(GLint value, float scale)
+		{
+			return std::max((float)value / scale, -1.0f);
+		}
+
+		GLenum type;	///< GL_INT_2_10_10_10_REV or GL_SHORT
+	};
+
+	/**
+	 * @brief Stores values between 0 and 1 as unsigned normalized bytes.
+	 */
+	class Unorm8Encoder : public AbstractVertexEncoder
+	{
+	public:
+		void GetFormat(GLint components, GLint& size, GLenum& type, GLboolean& normalized) const override
+		{
+			if (components < 1 || components > 4)
+				throw std::runtime_error("Unorm8 encoding requires 1 to 4 components");
+
+			size = components;
+			type = GL_UNSIGNED_BYTE;
+			normalized = GL_TRUE;
+		}
+
+		size_t GetEncodedSize(GLint components) const override
+		{
+			return components * sizeof(GLubyte);
+		}
+
+		void Encode(const GLfloat* input, GLint components, void* output) const override
+		{
+			GLubyte* values = static_cast<GLubyte*>(output);
+			for (GLint i = 0; i < components; i++)
+				values[i] = glm::packUnorm1x8(input[i]);
+		}
+
+		void Decode(const void* input, GLint components, GLfloat* output) const override
+		{
+			const GLubyte* values = static_cast<const GLubyte*>(input);
+			for (GLint i = 0; i < components; i++)
+				output[i] = glm::unpackUnorm1x8(values[i]);
+		}
+	};
+
+	VertexEncoder MakeHalfFloatEncoder()
+	{
+		return VertexEncoder(new HalfFloatEncoder);
+	}
+
+	VertexEncoder MakeOctahedralEncoder(GLenum type)
+	{
+		if (type != GL_INT_2_10_10_10_REV && type != GL_SHORT)
+			throw std::runtime_error("Octahedral encoding requires GL_INT_2_10_10_10_REV or GL_SHORT");
+
+		return VertexEncoder(new OctahedralEncoder(type));
+	}
+
+	VertexEncoder MakeUnorm8Encoder()
+	{
+		return VertexEncoder(new Unorm8Encoder);
+	}
+
+	MeshCompressionReport CompressMesh(MeshData& mesh, const AttributeEncoding* encodings, size_t encodingsSize)
+	{
+		encodingsSize /= sizeof(AttributeEncoding);
+
+		size_t vertexCount = mesh.GetVertexCount();
+		size_t stride = mesh.GetStride();
+
+		MeshCompressionReport report;
+		report.strideBefore = (GLsizei)stride;
+
+		// Lay out the new vertex, keeping every attribute 4 byte aligned
+		std::vector<const AbstractVertexEncoder*> encoders;
+		std::vector<VertexAttribute> topology;
+		size_t offset = 0;
+		for (const VertexAttribute& attribute : mesh.topology)
+		{
+			const AttributeEncoding* encoding = std::find_if(encodings, encodings + encodingsSize,
+				[&attribute](const AttributeEncoding& encoding) { return encoding.index == attribute.index; });
+
+			const AbstractVertexEncoder* encoder = (encoding != encodings + encodingsSize) ? encoding->encoder.get() : nullptr;
+			VertexAttribute compressed = attribute;
+			size_t size = GetVertexAttributeSize(attribute);
+			if (size == 0)
+				throw std::runtime_error("Unknown vertex attribute type: " + std::to_string(attribute.type));
+
+			if (encoder != nullptr)
+			{
+				if (attribute.type != GL_FLOAT || attribute.size > 4)
+					throw std::runtime_error("Only float vertex attributes can be encoded, attribute " + std::to_string(attribute.index) + " isn't");
+
+				encoder->GetFormat(attribute.size, compressed.size, compressed.type, compressed.normalized);
+				size = encoder->GetEncodedSize(attribute.size);
+			}
+
+			compressed.pointer = (const GLvoid*)offset;
+			report.attributes.push_back({ attribute.index, GetVertexAttributeSize(attribute), size, 0.0f });
+			encoders.push_back(encoder);
+			topology.push_back(compressed);
+			offset = (offset + size + 3) / 4 * 4;
+		}
+
+		size_t compressedStride = offset;
+		for (VertexAttribute& attribute : topology)
+			attribute.stride = (GLsizei)compressedStride;
+
+		report.strideAfter = (GLsizei)compressedStride;
+
+		// The packed data is kept in the float vector, the stride is a multiple of 4 bytes
+		std::vector<GLfloat> vertices(vertexCount * compressedStride / sizeof(GLfloat), 0.0f);
+		const unsigned char* source = reinterpret_cast<const unsigned char*>(mesh.vertices.data());
+		unsigned char* destination = reinterpret_cast<unsigned char*>(vertices.data());
+
+		GLfloat original[4], decoded[4];
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			for (size_t i = 0; i < topology.size(); i++)
+			{
+				const unsigned char* input = source + vertex * stride + (size_t)mesh.topology[i].pointer;
+				unsigned char* output = destination + vertex * compressedStride + (size_t)topology[i].pointer;
+
+				if (encoders[i] == nullptr)
+				{
+					memcpy(output, input, report.attributes[i].sizeAfter);
+					continue;
+				}
+
+				GLint components = mesh.topology[i].size;
+				memcpy(original, input, components * sizeof(GLfloat));
+				encoders[i]->Encode(original, components, output);
+				encoders[i]->Decode(output, components, decoded);
+
+				for (GLint component = 0; component < components; component++)
+					report.attributes[i].maxError = std::max(report.attributes[i].maxError, std::abs(decoded[component] - original[component]));
+			}
+		}
+
+		mesh.vertices.swap(vertices);
+		mesh.topology.swap(topology);
+		return report;
+	}
+}